@@ -18,13 +18,9 @@ Maestro maestro(sections, 1);
 // WS1812 stuff
 const unsigned char LED_PIN = 10;
 WS2812 ws = WS2812(ROWS * COLUMNS);
-cRGB RGBtoCRGB(Colors::RGB rgbColor) {
-  cRGB cRGBColor;
-  cRGBColor.r = rgbColor.r;
-  cRGBColor.g = rgbColor.g;
-  cRGBColor.b = rgbColor.b;
-  return cRGBColor;
-}
+
+// Stores the rendered frame (3 bytes per Pixel)
+unsigned char frame[ROWS * COLUMNS * 3];
 
 void setup () {
     ws.setOutput(LED_PIN);
@@ -38,10 +34,19 @@ void setup () {
 }
 
 void loop() {
-    maestro.update(millis());
+    // Only redraw the strip if something changed since the last frame
+    if (!maestro.update(millis()) || !maestro.get_changed()) {
+      return;
+    }
 
+    // Render the whole frame in one pass, then hand it to the LED library
+    maestro.render_frame(frame, Colors::ColorOrder::RGB, 3);
+    cRGB color;
     for (unsigned char pixel = 0; pixel < ROWS * COLUMNS; pixel++) {
-      ws.set_crgb_at(pixel, RGBtoCRGB(maestro.get_pixel_color(0, pixel)));
+      color.r = frame[pixel * 3];
+      color.g = frame[(pixel * 3) + 1];
+      color.b = frame[(pixel * 3) + 2];
+      ws.set_crgb_at(pixel, color);
     }
 
     ws.sync();
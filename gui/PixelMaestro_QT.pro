@@ -29,6 +29,8 @@ SOURCES += main.cpp\
 		../src/show/canvasdrawlineevent.cpp \
 		drawingarea/canvasdrawingarea.cpp \
 		../src/show/canvasdrawcircleevent.cpp \
+		../src/show/canvasdrawellipseevent.cpp \
+		../src/show/canvasdrawpolygonevent.cpp \
 		../src/show/canvasdrawtriangleevent.cpp \
 		../src/show/canvasdrawpointevent.cpp \
 		../src/show/canvasclearevent.cpp \
@@ -42,13 +44,17 @@ SOURCES += main.cpp\
 		../src/animation/sparkleanimation.cpp \
 		../src/animation/waveanimation.cpp \
 		../src/animation/animation.cpp \
+		../src/animation/indexmapanimation.cpp \
 		../src/show/sectionsetanimationevent.cpp \
 		../src/canvas/canvas.cpp \
 		../src/core/colors.cpp \
 		../src/core/maestro.cpp \
 		../src/core/pixel.cpp \
 		../src/core/point.cpp \
+		../src/core/gamma.cpp \
+		../src/core/random.cpp \
 		../src/core/section.cpp \
+		../src/core/threadpool.cpp \
 		../src/show/show.cpp \
 		../src/show/animationsetfadeevent.cpp \
 		../src/utility.cpp \
@@ -61,7 +67,9 @@ SOURCES += main.cpp\
     widget/animation/lightninganimationcontrol.cpp \
     widget/animation/plasmaanimationcontrol.cpp \
     widget/animation/sparkleanimationcontrol.cpp \
+    ../src/show/sectionaddlayerevent.cpp \
     ../src/show/sectionaddoverlayevent.cpp \
+    ../src/show/sectionremovelayerevent.cpp \
     ../src/show/sectionremoveoverlayevent.cpp \
     ../src/show/animationsetspeedevent.cpp
 
@@ -85,6 +93,8 @@ HEADERS += \
 		../src/show/canvasdrawlineevent.h \
 		drawingarea/canvasdrawingarea.h \
 		../src/show/canvasdrawcircleevent.h \
+		../src/show/canvasdrawellipseevent.h \
+		../src/show/canvasdrawpolygonevent.h \
 		../src/show/canvasdrawtriangleevent.h \
 		../src/show/canvasdrawpointevent.h \
 		../src/show/canvasclearevent.h \
@@ -98,13 +108,18 @@ HEADERS += \
 		../src/animation/sparkleanimation.h \
 		../src/animation/waveanimation.h \
 		../src/animation/animation.h \
+		../src/animation/indexmapanimation.h \
 		../src/show/sectionsetanimationevent.h \
 		../src/canvas/canvas.h \
 		../src/core/colors.h \
+		../src/core/executor.h \
 		../src/core/maestro.h \
 		../src/core/pixel.h \
 		../src/core/point.h \
+		../src/core/gamma.h \
+		../src/core/random.h \
 		../src/core/section.h \
+		../src/core/threadpool.h \
 		../src/show/animationsetfadeevent.h \
 		../src/show/show.h \
 		../src/utility.h \
@@ -117,7 +132,9 @@ HEADERS += \
     widget/animation/lightninganimationcontrol.h \
     widget/animation/plasmaanimationcontrol.h \
     widget/animation/sparkleanimationcontrol.h \
+    ../src/show/sectionaddlayerevent.h \
     ../src/show/sectionaddoverlayevent.h \
+    ../src/show/sectionremovelayerevent.h \
     ../src/show/sectionremoveoverlayevent.h \
     ../src/show/animationsetspeedevent.h
 
@@ -34,10 +34,19 @@ void SimpleDrawingArea::paintEvent(QPaintEvent *event) {
 		last_pixel_count_ = maestro_controller_->get_section_controller(section)->get_section()->get_dimensions()->size();
 	}
 
+	// Render the entire Maestro in one pass. Section 0 is at the start of the buffer.
+	unsigned int total_pixels = 0;
+	for (unsigned char i = 0; i < maestro_controller_->get_maestro()->get_num_sections(); i++) {
+		total_pixels += maestro_controller_->get_maestro()->get_section(i)->get_dimensions()->size();
+	}
+	frame_.resize(total_pixels * 3);
+	maestro_controller_->get_maestro()->render_frame(frame_.data(), Colors::ColorOrder::RGB, 3);
+
+	unsigned char* tmp_pixel;
 	for (unsigned short row = 0; row < maestro_controller_->get_section_controller(section)->get_section()->get_dimensions()->y; row++) {
-		for (unsigned short pixel = 0; pixel < maestro_controller_->get_section_controller(section)->get_section()->get_dimensions()->x; pixel++) {			
-			tmp_rgb_ = maestro_controller_->get_maestro()->get_pixel_color(section, maestro_controller_->get_section_controller(section)->get_section()->get_pixel_index(pixel, row));
-			tmp_color_.setRgb(tmp_rgb_.r, tmp_rgb_.g, tmp_rgb_.b);
+		for (unsigned short pixel = 0; pixel < maestro_controller_->get_section_controller(section)->get_section()->get_dimensions()->x; pixel++) {
+			tmp_pixel = &frame_[maestro_controller_->get_section_controller(section)->get_section()->get_pixel_index(pixel, row) * 3];
+			tmp_color_.setRgb(tmp_pixel[0], tmp_pixel[1], tmp_pixel[2]);
 			tmp_brush_.setColor(tmp_color_);
 			tmp_brush_.setStyle(Qt::BrushStyle::SolidPattern);
 
@@ -24,6 +24,9 @@ class SimpleDrawingArea : public MaestroDrawingArea {
 
 		/// Used to determine whether the Maestro's size has changed.
 		unsigned int last_pixel_count_ = 0;
+
+		/// Stores the Maestro's rendered output (3 bytes per Pixel).
+		std::vector<unsigned char> frame_;
 };
 
 #endif // SIMPLEDRAWINGAREA_H
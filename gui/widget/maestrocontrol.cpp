@@ -112,7 +112,7 @@ void MaestroControl::initialize() {
 	ui->sectionComboBox->addItem(QString("Overlay 1"));
 
 	// Initialize Overlay controls
-	ui->mix_modeComboBox->addItems({"None", "Alpha", "Multiply", "Overlay"});
+	ui->mix_modeComboBox->addItems({"None", "Alpha", "Multiply", "Overlay", "Add", "Screen", "Lighten", "Difference"});
 	ui->alphaSpinBox->setVisible(false);
 
 	get_section_settings();
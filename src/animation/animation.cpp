@@ -1,6 +1,9 @@
+#include "../utility.h"
 #include "animation.h"
 
 namespace PixelMaestro {
+	unsigned long Animation::num_animations_ = 0;
+
 	/**
 	 * Constructor.
 	 * @param section The Section that this animation will render in.
@@ -14,6 +17,10 @@ namespace PixelMaestro {
 		num_colors_ = num_colors;
 		speed_ = speed;
 		pause_ = pause;
+
+		// Seed each Animation differently, but the same way every run.
+		num_animations_++;
+		random_.set_seed(num_animations_);
 	}
 
 	/**
@@ -33,6 +40,14 @@ namespace PixelMaestro {
 		return &colors_[index];
 	}
 
+	/**
+	 * Returns the color palette.
+	 * @return Color palette.
+	 */
+	Colors::RGB* Animation::get_colors() {
+		return colors_;
+	}
+
 	/**
 	 * Returns the current cycle index.
 	 *
@@ -92,6 +107,18 @@ namespace PixelMaestro {
 		return speed_;
 	}
 
+	/**
+	 * Returns the time until the next animation cycle.
+	 * @param current_time The program's current runtime.
+	 * @return Time until the next cycle (in ms), 0 if the cycle is due, or the longest possible time if the Animation has no colors and never cycles.
+	 */
+	unsigned long Animation::get_time_until_cycle(const unsigned long& current_time) {
+		if (num_colors_ == 0 || colors_ == nullptr) {
+			return (unsigned long)-1;
+		}
+		return Utility::time_remaining(last_cycle_, speed_, current_time);
+	}
+
 	/**
 		Replaces the current color palette.
 
@@ -144,6 +171,15 @@ namespace PixelMaestro {
 		reverse_ = reverse;
 	}
 
+	/**
+	 * Restarts the Animation's random number stream from a seed.
+	 * Animations with the same seed generate the same random patterns.
+	 * @param seed New seed.
+	 */
+	void Animation::set_seed(unsigned long seed) {
+		random_.set_seed(seed);
+	}
+
 	/**
 	 * Sets the amount of time between animation updates.
 	 *
@@ -186,6 +222,17 @@ namespace PixelMaestro {
 		return false;
 	}
 
+	/**
+	 * Renders a range of rows.
+	 * Animations where each row can be rendered independently override this, then call Section::update_rows() from update().
+	 * This lets the Section split the rows into bands that render in parallel (see Section::set_executor()).
+	 * Implementations may be called from several threads at once, so they must only change the given rows and must not change the Animation's state.
+	 * @param section The parent Section.
+	 * @param start_row The first row to render.
+	 * @param end_row The row after the last row to render.
+	 */
+	void Animation::update_rows(Section*, unsigned short, unsigned short) { }
+
 	// Private methods
 
 	/**
@@ -215,4 +262,5 @@ namespace PixelMaestro {
 		}
 	}
 
+	Animation::~Animation() { }
 }
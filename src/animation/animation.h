@@ -2,6 +2,7 @@
 #define ANIMATION_H
 
 #include "../core/colors.h"
+#include "../core/random.h"
 #include "../core/section.h"
 
 namespace PixelMaestro {
@@ -17,7 +18,9 @@ namespace PixelMaestro {
 			};
 
 			Animation(Colors::RGB* colors = nullptr, unsigned char num_colors = 0, unsigned short speed = 100, unsigned short pause = 0);
+			virtual ~Animation();
 			Colors::RGB* get_color_at_index(unsigned char index);
+			Colors::RGB* get_colors();
 			unsigned char get_cycle_index();
 			bool get_fade();
 			unsigned char get_num_colors();
@@ -26,14 +29,17 @@ namespace PixelMaestro {
 			bool get_reverse();
 			unsigned short get_pause();
 			unsigned short get_speed();
+			unsigned long get_time_until_cycle(const unsigned long& current_time);
 			void set_colors(Colors::RGB* colors, unsigned char num_colors);
 			void set_cycle_index(unsigned char index);
 			void set_fade(bool fade);
 			void set_orientation(Orientations orientation);
 			void set_speed(unsigned short speed, unsigned short pause = 0);
 			void set_reverse(bool reverse);
+			void set_seed(unsigned long seed);
 			bool update(const unsigned long& current_time, Section *section);
 			virtual void update(Section* section) = 0;
+			virtual void update_rows(Section* section, unsigned short start_row, unsigned short end_row);
 
 		protected:			
 			/// Array of colors used in the animation.
@@ -54,6 +60,9 @@ namespace PixelMaestro {
 			/// The orientation of the animation. Defaults to HORIZONTAL.
 			Orientations orientation_ = Orientations::HORIZONTAL;
 
+			/// The Animation's own random number stream.
+			Random random_;
+
 			/// The amount of time (in milliseconds) to wait before starting an animation cycle. Defaults to 0.
 			unsigned short pause_ = 0;
 
@@ -64,6 +73,10 @@ namespace PixelMaestro {
 			unsigned short speed_ = 100;
 
 			void update_cycle(unsigned char min, unsigned char max);
+
+		private:
+			/// The number of Animations created so far. Used to give each Animation a different default seed.
+			static unsigned long num_animations_;
 	};
 }
 
@@ -0,0 +1,106 @@
+#include "indexmapanimation.h"
+
+namespace PixelMaestro {
+	IndexMapAnimation::IndexMapAnimation(Colors::RGB* colors, unsigned char num_colors, unsigned short speed, unsigned short pause) : Animation(colors, num_colors, speed, pause) { }
+
+	/**
+	 * Forces the index map to be recalculated on the next update.
+	 * Derived animations call this when changing a parameter that affects the pattern.
+	 */
+	void IndexMapAnimation::invalidate_map() {
+		map_stale_ = true;
+	}
+
+	/**
+	 * Recalculates the index map if needed, then updates each Pixel from the map.
+	 * In the Section's INDEXED storage mode, Pixels store the cached index directly and the cycle is applied by rotating the Section's palette.
+	 * @param section The parent Section.
+	 */
+	void IndexMapAnimation::update(Section* section) {
+		if (num_colors_ == 0) {
+			return;
+		}
+
+		Point* size = section->get_dimensions();
+		if (*size != map_size_ || orientation_ != map_orientation_ || num_colors_ != map_num_colors_) {
+			if (size->size() != map_size_.size()) {
+				delete [] index_map_;
+				index_map_ = new unsigned char[size->size()];
+			}
+			map_size_ = *size;
+			map_orientation_ = orientation_;
+			map_num_colors_ = num_colors_;
+			map_stale_ = true;
+		}
+
+		if (map_stale_) {
+			prepare_map(section);
+		}
+
+		if (section->get_storage_mode() == Section::StorageMode::INDEXED) {
+			section->set_palette_offset(cycle_index_);
+		}
+
+		section->update_rows(this);
+		map_stale_ = false;
+
+		update_cycle(0, num_colors_);
+	}
+
+	/**
+	 * Updates a range of rows from the index map, recalculating the map first if needed.
+	 * @param section The parent Section.
+	 * @param start_row The first row to update.
+	 * @param end_row The row after the last row to update.
+	 */
+	void IndexMapAnimation::update_rows(Section* section, unsigned short start_row, unsigned short end_row) {
+		unsigned short width = section->get_dimensions()->x;
+		unsigned int pixel = start_row * width;
+		unsigned int end_pixel = end_row * width;
+
+		if (map_stale_) {
+			for (unsigned short y = start_row; y < end_row; y++) {
+				for (unsigned short x = 0; x < width; x++) {
+					int index = get_map_index(section, x, y);
+					index_map_[(y * width) + x] = (index < 0) ? Section::INDEX_OFF : (unsigned char)(index % num_colors_);
+				}
+			}
+		}
+
+		if (section->get_storage_mode() == Section::StorageMode::INDEXED) {
+			for (; pixel < end_pixel; pixel++) {
+				section->set_one_index(pixel, index_map_[pixel]);
+			}
+			return;
+		}
+
+		/*
+		 * Map indices and the cycle index are both less than the number of colors, so the sum only ever needs to wrap once.
+		 * cycle_index_ can equal num_colors_ after set_cycle_index(), so it's reduced first.
+		 */
+		unsigned char cycle_index = (cycle_index_ < num_colors_) ? cycle_index_ : 0;
+		unsigned short index;
+		for (; pixel < end_pixel; pixel++) {
+			if (index_map_[pixel] == Section::INDEX_OFF) {
+				section->set_one(pixel, &Colors::BLACK);
+			}
+			else {
+				index = index_map_[pixel] + cycle_index;
+				if (index >= num_colors_) {
+					index -= num_colors_;
+				}
+				section->set_one(pixel, &colors_[index]);
+			}
+		}
+	}
+
+	/**
+	 * Called before the index map is recalculated. Derived animations can override this to calculate values shared by every Pixel.
+	 * @param section The parent Section.
+	 */
+	void IndexMapAnimation::prepare_map(Section*) { }
+
+	IndexMapAnimation::~IndexMapAnimation() {
+		delete [] index_map_;
+	}
+}
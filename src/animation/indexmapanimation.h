@@ -0,0 +1,61 @@
+/*
+ * IndexMapAnimation - Base class for animations that rotate the palette across a fixed pattern.
+ */
+
+#ifndef INDEXMAPANIMATION_H
+#define INDEXMAPANIMATION_H
+
+#include "../core/point.h"
+#include "animation.h"
+
+namespace PixelMaestro {
+	/**
+		Many animations (e.g. Wave, Radial, Plasma) assign each Pixel a palette index based on its position, then rotate the palette by the cycle index.
+		IndexMapAnimation calculates each Pixel's position-based index once and caches it in an index map.
+		Each cycle then only adds the cycle index to the cached value.
+		The map is recalculated when the Section size, orientation, or number of colors changes, or when invalidate_map() is called.
+	*/
+	class IndexMapAnimation : public Animation {
+		public:
+			IndexMapAnimation(Colors::RGB* colors = nullptr, unsigned char num_colors = 0, unsigned short speed = 100, unsigned short pause = 0);
+			~IndexMapAnimation();
+			void invalidate_map();
+			void update(Section* section);
+			void update_rows(Section* section, unsigned short start_row, unsigned short end_row);
+
+		protected:
+			/// Returned by get_map_index() to turn a Pixel off.
+			static const int MAP_OFF = -1;
+
+			/**
+				Calculates the palette index of a Pixel before applying the cycle index.
+				This may be called from several threads at once, so it must not change the Animation's state.
+
+				@param section The parent Section.
+				@param x The Pixel's x-coordinate.
+				@param y The Pixel's y-coordinate.
+				@return The Pixel's palette index, or MAP_OFF to turn the Pixel off.
+			*/
+			virtual int get_map_index(Section* section, unsigned short x, unsigned short y) = 0;
+
+			virtual void prepare_map(Section* section);
+
+		private:
+			/// The cached palette index of each Pixel, reduced to the size of the palette. Section::INDEX_OFF turns the Pixel off.
+			unsigned char* index_map_ = nullptr;
+
+			/// The number of colors in the palette when the map was calculated.
+			unsigned char map_num_colors_ = 0;
+
+			/// The orientation when the map was calculated.
+			Orientations map_orientation_ = Orientations::HORIZONTAL;
+
+			/// The size of the Section when the map was calculated.
+			Point map_size_ = {0, 0};
+
+			/// Whether the map needs to be recalculated.
+			bool map_stale_ = true;
+	};
+}
+
+#endif // INDEXMAPANIMATION_H
@@ -1,4 +1,3 @@
-#include "../utility.h"
 #include "lightninganimation.h"
 
 namespace PixelMaestro {
@@ -16,10 +15,10 @@ namespace PixelMaestro {
 		// Assume horizontal movement. Choose a random point on the y-axis starting at 0, then move from left to right.
 		Point start = {0, 0};
 		if (orientation_ == Orientations::VERTICAL) {
-			start.set((unsigned short)Utility::rand(section->get_dimensions()->x), 0);
+			start.set(random_.next_range(section->get_dimensions()->x), 0);
 		}
 		else {
-			start.set(0, (unsigned short)Utility::rand(section->get_dimensions()->y));
+			start.set(0, random_.next_range(section->get_dimensions()->y));
 		}
 
 		for (unsigned char bolt = 0; bolt < num_bolts_; bolt++) {
@@ -60,7 +59,7 @@ namespace PixelMaestro {
 		 * For each step along the grid, roll the dice and compare it to the down/up thresholds.
 		 */
 		for (unsigned short x = cursor.x; x < length; x++) {
-			direction_roll = Utility::rand(255);
+			direction_roll = random_.next_byte();
 			if (direction_roll > up_threshold) {
 				if (cursor.y + 1 < section->get_dimensions()->y) {
 					cursor.y += 1;
@@ -78,7 +77,7 @@ namespace PixelMaestro {
 
 			// Check to see if we should fork the bolt
 			if (x < (unsigned short)section->get_dimensions()->x) {
-				unsigned char chance_roll = Utility::rand(255);
+				unsigned char chance_roll = random_.next_byte();
 				if (chance_roll < fork_chance) {
 					/*
 					 * If we fork, reduce the fork chance by 50%.
@@ -125,7 +124,7 @@ namespace PixelMaestro {
 		 * For each step along the grid, roll the dice and compare it to the down/up thresholds.
 		 */
 		for (unsigned short y = cursor.y; y < length; y++) {
-			direction_roll = Utility::rand(255);
+			direction_roll = random_.next_byte();
 			if (direction_roll > right_threshold) {
 				if (cursor.x + 1 < section->get_dimensions()->x) {
 					cursor.x += 1;
@@ -142,7 +141,7 @@ namespace PixelMaestro {
 
 			// Check to see if we should fork the bolt
 			if (y < (unsigned short)section->get_dimensions()->y) {
-				unsigned char chance_roll = Utility::rand(255);
+				unsigned char chance_roll = random_.next_byte();
 				if (chance_roll < fork_chance) {
 					/*
 					 * If we fork, reduce the fork chance by 50%.
@@ -1,64 +1,238 @@
+#include <math.h>
 #include "../utility.h"
 #include "mandelbrotanimation.h"
 
 namespace PixelMaestro {
-	MandelbrotAnimation::MandelbrotAnimation(Colors::RGB* colors, unsigned char num_colors, unsigned short speed, unsigned short pause) : Animation(colors, num_colors, speed, pause) {	}
+	MandelbrotAnimation::MandelbrotAnimation(Colors::RGB* colors, unsigned char num_colors, unsigned short speed, unsigned short pause, unsigned short max_iterations) : IndexMapAnimation(colors, num_colors, speed, pause) {
+		max_iterations_ = max_iterations;
+	}
+
+	/**
+	 * Returns the imaginary coordinate at the center of the Section.
+	 * @return Imaginary coordinate.
+	 */
+	double MandelbrotAnimation::get_center_imaginary() {
+		return center_imaginary_;
+	}
+
+	/**
+	 * Returns the real coordinate at the center of the Section.
+	 * @return Real coordinate.
+	 */
+	double MandelbrotAnimation::get_center_real() {
+		return center_real_;
+	}
+
+	/**
+	 * Returns the maximum number of iterations per Pixel.
+	 * @return Maximum iterations. 0 means the number of colors in the palette.
+	 */
+	unsigned short MandelbrotAnimation::get_max_iterations() {
+		return max_iterations_;
+	}
+
+	/**
+	 * Returns the zoom level.
+	 * @return Zoom level.
+	 */
+	double MandelbrotAnimation::get_zoom() {
+		return zoom_;
+	}
+
+	/**
+	 * Forces every Pixel to be iterated again on the next update.
+	 */
+	void MandelbrotAnimation::invalidate_cache() {
+		cache_valid_ = false;
+		invalidate_map();
+	}
+
+	/**
+	 * Sets the point in the complex plane shown at the center of the Section.
+	 * Cancels any movement towards a target.
+	 * @param real Real coordinate.
+	 * @param imaginary Imaginary coordinate.
+	 */
+	void MandelbrotAnimation::set_center(double real, double imaginary) {
+		center_real_ = real;
+		center_imaginary_ = imaginary;
+		target_cycles_ = 0;
+		invalidate_cache();
+	}
+
+	/**
+	 * Sets the maximum number of iterations per Pixel.
+	 * Higher values show more detail, especially when zoomed in, but take longer to calculate.
+	 * Colors repeat when there are more iterations than colors.
+	 * @param max_iterations Maximum iterations. If 0, uses the number of colors in the palette.
+	 */
+	void MandelbrotAnimation::set_max_iterations(unsigned short max_iterations) {
+		max_iterations_ = max_iterations;
+		invalidate_cache();
+	}
+
+	/**
+	 * Moves the view towards a new center and zoom level over several cycles.
+	 * The center moves in a straight line, and the zoom changes by the same factor each cycle.
+	 * @param real Real coordinate of the new center.
+	 * @param imaginary Imaginary coordinate of the new center.
+	 * @param zoom New zoom level. Must be greater than 0, otherwise the target is ignored.
+	 * @param cycles Number of cycles to reach the target.
+	 */
+	void MandelbrotAnimation::set_target(double real, double imaginary, double zoom, unsigned short cycles) {
+		if (!(zoom > 0)) {
+			return;
+		}
+
+		if (cycles == 0) {
+			set_center(real, imaginary);
+			set_zoom(zoom);
+			return;
+		}
+
+		target_real_ = real;
+		target_imaginary_ = imaginary;
+		target_zoom_ = zoom;
+		target_cycles_ = cycles;
+	}
 
-	void MandelbrotAnimation::set_colors(Colors::RGB *colors, unsigned char num_colors) {
-		colors_ = colors;
-		num_colors_ = num_colors;
-		max_iterations_ = num_colors;
+	/**
+	 * Sets the zoom level. At a zoom level of 1, the Section spans 4 units along the x-axis.
+	 * Cancels any movement towards a target.
+	 * @param zoom Zoom level. Must be greater than 0, otherwise it's ignored.
+	 */
+	void MandelbrotAnimation::set_zoom(double zoom) {
+		// The view width is divided by the zoom level, so 0, negative, and NaN levels can't be displayed.
+		if (!(zoom > 0)) {
+			return;
+		}
+
+		zoom_ = zoom;
+		target_cycles_ = 0;
+		invalidate_cache();
 	}
 
 	void MandelbrotAnimation::update(Section* section) {
-		if (size_ != *section->get_dimensions()) {
-			size_ = *section->get_dimensions();
+		if (num_colors_ == 0) {
+			return;
+		}
 
-			// Recalculate center and width in case the Section size has changed.
-			center_ = {
-				(unsigned short)(section->get_dimensions()->x / 2),
-				(unsigned short)(section->get_dimensions()->y / 2)
-			};
+		// Take the next step towards the target.
+		if (target_cycles_ > 0) {
+			center_real_ += (target_real_ - center_real_) / target_cycles_;
+			center_imaginary_ += (target_imaginary_ - center_imaginary_) / target_cycles_;
+			zoom_ *= pow(target_zoom_ / zoom_, 1.0 / target_cycles_);
+			target_cycles_--;
+			invalidate_cache();
+		}
+
+		IndexMapAnimation::update(section);
+		cache_valid_ = true;
+	}
+
+	void MandelbrotAnimation::prepare_map(Section* section) {
+		// In the vertical orientation, the pattern is drawn with the x and y axes swapped.
+		Point size = *section->get_dimensions();
+		if (orientation_ == Orientations::VERTICAL) {
+			size = {size.y, size.x};
+		}
+
+		if (*section->get_dimensions() != cache_size_ || orientation_ != cache_orientation_) {
+			if (section->get_dimensions()->size() != cache_size_.size()) {
+				delete [] iterations_;
+				iterations_ = new unsigned short[section->get_dimensions()->size()];
+			}
+			cache_size_ = *section->get_dimensions();
+			cache_orientation_ = orientation_;
+			cache_valid_ = false;
+		}
 
-			// Calculate the scale of the pattern
-			image_width_ = 4.0 / size_.x;
+		// By default, run one iteration per color. This only invalidates the cache when the palette size changes.
+		unsigned short iteration_limit = (max_iterations_ > 0) ? max_iterations_ : num_colors_;
+		if (iteration_limit != iteration_limit_) {
+			iteration_limit_ = iteration_limit;
+			cache_valid_ = false;
 		}
 
-		for (unsigned short y = 0; y < size_.y; y++) {
-			c_imaginary_ = (y - center_.y) * image_width_;
-			for (unsigned short x = 0; x < size_.x; x++) {
-				c_real_ = (x - center_.x) * image_width_;
+		// Recalculate center and width in case the Section size has changed.
+		center_ = {
+			(unsigned short)(size.x / 2),
+			(unsigned short)(size.y / 2)
+		};
+
+		// Calculate the scale of the pattern
+		image_width_ = 4.0 / (size.x * zoom_);
+	}
 
-				x_ = 0;
-				y_ = 0;
-				iterations_ = 0;
+	int MandelbrotAnimation::get_map_index(Section* section, unsigned short column, unsigned short row) {
+		unsigned short* iterations = &iterations_[(row * section->get_dimensions()->x) + column];
 
-				while ((x_ * x_) + (y_ * y_) < 4 && iterations_ < max_iterations_) {
-					x_2_ = (x_ * x_) - (y_ * y_) + c_real_;
-					y_ = (2.0 * x_ * y_) + c_imaginary_;
-					x_ = x_2_;
-					iterations_++;
-				}
+		// If only the palette changed, reuse the last result.
+		if (!cache_valid_) {
+			// Stores complex real and imaginary numbers for the current Pixel.
+			double c_real, c_imaginary;
+			if (orientation_ == Orientations::VERTICAL) {
+				c_real = center_real_ + ((row - center_.x) * image_width_);
+				c_imaginary = center_imaginary_ + ((column - center_.y) * image_width_);
+			}
+			else {
+				c_real = center_real_ + ((column - center_.x) * image_width_);
+				c_imaginary = center_imaginary_ + ((row - center_.y) * image_width_);
+			}
+
+			*iterations = 0;
+
+			/*
+			 * Points in the main cardioid and the period-2 bulb never escape, so skip iterating them.
+			 * See https://en.wikipedia.org/wiki/Plotting_algorithms_for_the_Mandelbrot_set#Cardioid_/_bulb_checking
+			 */
+			double q = ((c_real - 0.25) * (c_real - 0.25)) + (c_imaginary * c_imaginary);
+			if ((q * (q + (c_real - 0.25))) <= (0.25 * c_imaginary * c_imaginary) ||
+				((c_real + 1) * (c_real + 1)) + (c_imaginary * c_imaginary) <= 0.0625) {
+				*iterations = iteration_limit_;
+			}
+
+			// Temporary holders for Mandelbrot function.
+			double x = 0, y = 0, x_2 = 0, y_2 = 0;
+
+			/*
+			 * Periodicity checking: if the orbit returns to a point it's already visited, it will never escape.
+			 * The saved point is replaced at increasing intervals so that longer cycles are also caught.
+			 */
+			double saved_x = 0, saved_y = 0;
+			unsigned int period = 0, period_length = 8;
 
-				if (orientation_ == Orientations::VERTICAL) {
-					if (iterations_ < max_iterations_) {
-						section->set_one(y, x, get_color_at_index(iterations_ + cycle_index_));
-					}
-					else {
-						section->set_one(y, x, &Colors::BLACK);
-					}
+			while (x_2 + y_2 < 4 && *iterations < iteration_limit_) {
+				y = (2.0 * x * y) + c_imaginary;
+				x = x_2 - y_2 + c_real;
+				x_2 = x * x;
+				y_2 = y * y;
+				(*iterations)++;
+
+				if (x == saved_x && y == saved_y) {
+					*iterations = iteration_limit_;
+					break;
 				}
-				else {
-					if (iterations_ < max_iterations_) {
-						section->set_one(x, y, get_color_at_index(iterations_ + cycle_index_));
-					}
-					else {
-						section->set_one(x, y, &Colors::BLACK);
-					}
+
+				period++;
+				if (period == period_length) {
+					period = 0;
+					period_length *= 2;
+					saved_x = x;
+					saved_y = y;
 				}
 			}
 		}
 
-		update_cycle(0, num_colors_);
+		if (*iterations < iteration_limit_) {
+			return *iterations;
+		}
+		else {
+			return MAP_OFF;
+		}
+	}
+
+	MandelbrotAnimation::~MandelbrotAnimation() {
+		delete [] iterations_;
 	}
 }
@@ -7,37 +7,74 @@
 #define MANDELBROTANIMATION_H
 
 #include "../core/point.h"
-#include "animation.h"
+#include "indexmapanimation.h"
 
 namespace PixelMaestro {
-	class MandelbrotAnimation : public Animation {
+	class MandelbrotAnimation : public IndexMapAnimation {
 		public:
-			MandelbrotAnimation(Colors::RGB* colors = nullptr, unsigned char num_colors = 0, unsigned short speed = 100, unsigned short pause = 0);
-			void set_colors(Colors::RGB *colors, unsigned char num_colors);
+			MandelbrotAnimation(Colors::RGB* colors = nullptr, unsigned char num_colors = 0, unsigned short speed = 100, unsigned short pause = 0, unsigned short max_iterations = 0);
+			~MandelbrotAnimation();
+			double get_center_imaginary();
+			double get_center_real();
+			unsigned short get_max_iterations();
+			double get_zoom();
+			void set_center(double real, double imaginary);
+			void set_max_iterations(unsigned short max_iterations);
+			void set_target(double real, double imaginary, double zoom, unsigned short cycles);
+			void set_zoom(double zoom);
 			void update(Section* section);
 
+		protected:
+			int get_map_index(Section* section, unsigned short x, unsigned short y);
+			void prepare_map(Section* section);
+
 		private:
+			/// Whether iterations_ matches the current view.
+			bool cache_valid_ = false;
+
+			/// The orientation of the cached iterations.
+			Orientations cache_orientation_ = Orientations::HORIZONTAL;
 
-			/// Stores complex real and imaginary numbers for each Pixel.
-			double c_real_, c_imaginary_;
+			/// The size of the Section when the iterations were cached.
+			Point cache_size_ = {0, 0};
 
-			/// The center of the image.
+			/// The center of the Section in Pixels.
 			Point center_ = {0, 0};
 
-			/// Stores the calculated width of the image.
-			double image_width_;
+			/// The imaginary coordinate shown at the center of the Section.
+			double center_imaginary_ = 0;
+
+			/// The real coordinate shown at the center of the Section.
+			double center_real_ = 0;
+
+			/// The distance between Pixels in the complex plane.
+			double image_width_ = 0;
+
+			/// The cached number of iterations for each Pixel.
+			unsigned short* iterations_ = nullptr;
+
+			/// The iteration limit used for the cached iterations. Resolved from max_iterations_ in prepare_map().
+			unsigned short iteration_limit_ = 0;
+
+			/// Maximum number of iterations to run. Pixels that reach this limit are inside the set and turn off. If 0, uses the number of colors in the palette.
+			unsigned short max_iterations_;
+
+			/// The number of cycles left before reaching the target view.
+			unsigned short target_cycles_ = 0;
+
+			/// The imaginary coordinate to move towards.
+			double target_imaginary_ = 0;
 
-			/// Tracks the number of runs through the Mandelbrot function for each Pixel.
-			unsigned char iterations_ = 0;
+			/// The real coordinate to move towards.
+			double target_real_ = 0;
 
-			/// Maximum number of iterations to run. Defaults to num_colors.
-			unsigned char max_iterations_ = 10;
+			/// The zoom level to move towards.
+			double target_zoom_ = 1;
 
-			/// Stores grid size for comparison.
-			Point size_ = {0, 0};
+			/// The zoom level. At 1, the Section spans 4 units along the x-axis.
+			double zoom_ = 1;
 
-			/// Temporary holders for Mandelbrot function.
-			double x_, x_2_, y_;
+			void invalidate_cache();
 	};
 }
 
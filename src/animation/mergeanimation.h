@@ -1,20 +1,23 @@
 #ifndef MERGEANIMATION_H
 #define MERGEANIMATION_H
 
-#include "animation.h"
+#include "indexmapanimation.h"
 
 namespace PixelMaestro {
-	class MergeAnimation : public Animation {
+	class MergeAnimation : public IndexMapAnimation {
 		public:
 			MergeAnimation(Colors::RGB* colors = nullptr, unsigned char num_colors = 0, unsigned short speed = 100, unsigned short pause = 0);
-			void update(Section* section);
+
+		protected:
+			int get_map_index(Section* section, unsigned short x, unsigned short y);
+			void prepare_map(Section* section);
 
 		private:
-			/// Counter for the current Pixel index.
-			unsigned short count_ = 0;
+			/// Stores the last Pixel before the center of the array.
+			int mid_point_ = 0;
 
-			/// Stores the array center.
-			unsigned short mid_point_ = 0;
+			/// Whether the Section has an odd number of Pixels.
+			bool odd_ = false;
 	};
 }
 
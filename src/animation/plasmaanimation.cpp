@@ -1,10 +1,38 @@
 #include <math.h>
+#include "../utility.h"
 #include "plasmaanimation.h"
 
 namespace PixelMaestro {
-	PlasmaAnimation::PlasmaAnimation(Colors::RGB* colors, unsigned char num_colors, unsigned short speed, unsigned short pause, float size, float resolution) : Animation(colors, num_colors, speed, pause) {
-		resolution_ = resolution;
-		size_ = size;
+	PlasmaAnimation::PlasmaAnimation(Colors::RGB* colors, unsigned char num_colors, unsigned short speed, unsigned short pause, float size, float resolution, unsigned char motion) : IndexMapAnimation(colors, num_colors, speed, pause) {
+		set_resolution(resolution);
+		set_size(size);
+		motion_ = motion;
+	}
+
+	/**
+	 * Frees the lookup tables.
+	 */
+	void PlasmaAnimation::delete_tables() {
+		delete [] column_rings_;
+		delete [] column_values_;
+		delete [] column_waves_;
+		delete [] row_rings_;
+		delete [] row_values_;
+		delete [] row_waves_;
+		column_rings_ = nullptr;
+		column_values_ = nullptr;
+		column_waves_ = nullptr;
+		row_rings_ = nullptr;
+		row_values_ = nullptr;
+		row_waves_ = nullptr;
+	}
+
+	/**
+	 * Returns how far the plasma moves each cycle.
+	 * @return Plasma motion.
+	 */
+	unsigned char PlasmaAnimation::get_motion() {
+		return motion_;
 	}
 
 	/**
@@ -23,12 +51,27 @@ namespace PixelMaestro {
 		return size_;
 	}
 
+	/**
+	 * Sets how far the plasma moves each cycle, in 256ths of a wave.
+	 * At 0, the plasma stays still and only the palette cycles.
+	 * @param motion Plasma motion.
+	 */
+	void PlasmaAnimation::set_motion(unsigned char motion) {
+		this->motion_ = motion;
+		invalidate_map();
+	}
+
 	/**
 	 * Sets the resolution (sharpness) of each plasma.
 	 * @param resolution Plasma resolution.
 	 */
 	void PlasmaAnimation::set_resolution(float resolution) {
 		this->resolution_ = resolution;
+
+		// The moving waves add up to 765 at most, which maps to the static plasma's range of 0 - (resolution * 2).
+		band_scale_ = (resolution > 0) ? (unsigned short)((resolution * 2 * 256) / 765) : 0;
+
+		invalidate_map();
 	}
 
 	/**
@@ -37,18 +80,101 @@ namespace PixelMaestro {
 	 */
 	void PlasmaAnimation::set_size(float size) {
 		this->size_ = size;
+
+		// sin(x / size) completes a wave every (2 * pi * size) Pixels. sin8() completes a wave every 256 units.
+		float frequency = (size > 0) ? (256 * 256) / (6.2831853 * size) : 0;
+		frequency_ = (frequency < 65535) ? (unsigned short)frequency : 65535;
+
+		invalidate_map();
 	}
 
 	void PlasmaAnimation::update(Section* section) {
-		int color_index;
+		IndexMapAnimation::update(section);
 
-		for (unsigned short y = 0; y < section->get_dimensions()->y; y++) {
-			for (unsigned short x = 0; x < section->get_dimensions()->x; x++) {
-				color_index = ((resolution_ + (resolution_ * sin(x / size_))) + (resolution_ + (resolution_ * sin(y / size_)))) / 2;
-				section->set_one(x, y, get_color_at_index(color_index + cycle_index_));
+		// A moving plasma changes every Pixel, so the map is recalculated each cycle.
+		if (motion_ > 0) {
+			time_ += motion_;
+			invalidate_map();
+		}
+	}
+
+	void PlasmaAnimation::prepare_map(Section* section) {
+		Point* size = section->get_dimensions();
+		bool motion = (motion_ > 0);
+		if (*size != table_size_ || motion != table_motion_) {
+			delete_tables();
+			if (motion) {
+				column_rings_ = new unsigned short[size->x];
+				column_waves_ = new unsigned char[size->x];
+				row_rings_ = new unsigned short[size->y];
+				row_waves_ = new unsigned char[size->y];
 			}
+			else {
+				column_values_ = new float[size->x];
+				row_values_ = new float[size->y];
+			}
+			table_size_ = *size;
+			table_motion_ = motion;
 		}
 
-		update_cycle(0, num_colors_);
+		if (motion) {
+			prepare_motion(size);
+			return;
+		}
+
+		// The plasma is the sum of a wave along each axis, so each wave only needs to be calculated once per column and once per row.
+		for (unsigned short x = 0; x < size->x; x++) {
+			column_values_[x] = resolution_ + (resolution_ * sin(x / size_));
+		}
+		for (unsigned short y = 0; y < size->y; y++) {
+			row_values_[y] = resolution_ + (resolution_ * sin(y / size_));
+		}
+	}
+
+	/**
+	 * Calculates the tables for the moving plasma at the current phase.
+	 * The plasma combines two waves along each axis (a base wave and a faster octave moving the other way) with rings around a wandering center.
+	 * Everything uses integer math, so each Pixel only needs a few table lookups.
+	 * @param size The size of the Section.
+	 */
+	void PlasmaAnimation::prepare_motion(Point* size) {
+		unsigned char phase = time_;
+
+		// Move the center of the rings in a loop around the middle of the Section.
+		long center_x = (size->x / 2) + (((long)Utility::sin8(time_ >> 2) - 128) * size->x) / 512;
+		long center_y = (size->y / 2) + (((long)Utility::sin8((time_ >> 2) + 64) - 128) * size->y) / 512;
+
+		unsigned long angle;
+		long distance;
+		for (unsigned short x = 0; x < size->x; x++) {
+			angle = ((unsigned long)x * frequency_) >> 8;
+			column_waves_[x] = ((2 * Utility::sin8(angle + phase)) + Utility::sin8((angle * 2) - phase)) / 3;
+
+			distance = x - center_x;
+			column_rings_[x] = ((unsigned long)(distance * distance) * frequency_) >> 4;
+		}
+
+		// Rows move at a different rate than columns so that the pattern doesn't just slide diagonally.
+		phase = (time_ * 3) >> 1;
+		for (unsigned short y = 0; y < size->y; y++) {
+			angle = ((unsigned long)y * frequency_) >> 8;
+			row_waves_[y] = ((2 * Utility::sin8(angle - phase)) + Utility::sin8((angle * 2) + phase)) / 3;
+
+			distance = y - center_y;
+			row_rings_[y] = ((unsigned long)(distance * distance) * frequency_) >> 4;
+		}
+	}
+
+	int PlasmaAnimation::get_map_index(Section*, unsigned short x, unsigned short y) {
+		if (table_motion_) {
+			unsigned short value = column_waves_[x] + row_waves_[y] + Utility::sin8((unsigned short)(column_rings_[x] + row_rings_[y]) >> 8);
+			return ((unsigned long)value * band_scale_) >> 8;
+		}
+
+		return (column_values_[x] + row_values_[y]) / 2;
+	}
+
+	PlasmaAnimation::~PlasmaAnimation() {
+		delete_tables();
 	}
 }
@@ -1,24 +1,71 @@
 #ifndef PLASMAANIMATION_H
 #define PLASMAANIMATION_H
 
-#include "animation.h"
+#include "../core/point.h"
+#include "indexmapanimation.h"
 
 namespace  PixelMaestro {
-	class PlasmaAnimation : public Animation {
+	class PlasmaAnimation : public IndexMapAnimation {
 		public:
-			PlasmaAnimation(Colors::RGB* colors = nullptr, unsigned char num_colors = 0, unsigned short speed = 100, unsigned short pause = 0, float size = 4.0, float resolution = 32.0);
+			PlasmaAnimation(Colors::RGB* colors = nullptr, unsigned char num_colors = 0, unsigned short speed = 100, unsigned short pause = 0, float size = 4.0, float resolution = 32.0, unsigned char motion = 0);
+			~PlasmaAnimation();
+			unsigned char get_motion();
 			float get_resolution();
 			float get_size();
+			void set_motion(unsigned char motion);
 			void set_resolution(float resolution);
 			void set_size(float size);
 			void update(Section* section);
 
+		protected:
+			int get_map_index(Section* section, unsigned short x, unsigned short y);
+			void prepare_map(Section* section);
+
 		private:
+			/// Fixed-point scale (8.8) from the sum of the moving waves to a palette index.
+			unsigned short band_scale_ = 0;
+
+			/// The ring wave's contribution from each column, in 16ths of sin8() units.
+			unsigned short* column_rings_ = nullptr;
+
+			/// The static plasma's contribution from each column.
+			float* column_values_ = nullptr;
+
+			/// The moving plasma's contribution from each column.
+			unsigned char* column_waves_ = nullptr;
+
+			/// Fixed-point (8.8) distance travelled by each wave per Pixel, in sin8() units.
+			unsigned short frequency_ = 0;
+
+			/// How far the moving plasma advances each cycle. 0 keeps the plasma still.
+			unsigned char motion_;
+
 			/// The resolution of each plasma (i.e. the number of bands).
 			float resolution_;
 
+			/// The ring wave's contribution from each row, in 16ths of sin8() units.
+			unsigned short* row_rings_ = nullptr;
+
+			/// The static plasma's contribution from each row.
+			float* row_values_ = nullptr;
+
+			/// The moving plasma's contribution from each row.
+			unsigned char* row_waves_ = nullptr;
+
 			/// The size of each plasma.
 			float size_;
+
+			/// Whether the tables were allocated for the moving plasma.
+			bool table_motion_ = false;
+
+			/// The size of the Section when the tables were allocated.
+			Point table_size_ = {0, 0};
+
+			/// The phase of the moving plasma.
+			unsigned short time_ = 0;
+
+			void delete_tables();
+			void prepare_motion(Point* size);
 	};
 }
 
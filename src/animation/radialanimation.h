@@ -2,29 +2,20 @@
 #define RADIALANIMATION_H
 
 #include "../core/point.h"
-#include "animation.h"
+#include "indexmapanimation.h"
 
 namespace PixelMaestro {
-	class RadialAnimation : public Animation {
+	class RadialAnimation : public IndexMapAnimation {
 		public:
 			RadialAnimation(Colors::RGB* colors = nullptr, unsigned char num_colors = 0, unsigned short speed = 100, unsigned short pause = 0);
-			void update(Section* section);
+
+		protected:
+			int get_map_index(Section* section, unsigned short x, unsigned short y);
+			void prepare_map(Section* section);
 
 		private:
 			/// Tracks the center of the grid.
 			Point center_ = {0, 0};
-
-			/// Tracks the distance of the current point from the center.
-			unsigned short distance_ = 0;
-
-			/// Stores the size of the array to check for resizes.
-			Point size_ = {0, 0};
-
-			/// Stores the slope between a Pixel and the center of the grid.
-			unsigned short slope_;
-
-			/// Stores the square of the current x-axis.
-			unsigned short y_squared_ = 0;
 	};
 }
 
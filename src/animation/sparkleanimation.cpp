@@ -1,4 +1,3 @@
-#include "../utility.h"
 #include "sparkleanimation.h"
 
 namespace PixelMaestro {
@@ -23,10 +22,21 @@ namespace PixelMaestro {
 	}
 
 	void SparkleAnimation::update(Section* section) {
+		Point* dimensions = section->get_dimensions();
+
+		// Generate the Pixels for a whole row (or column) at once instead of one random number per Pixel.
+		unsigned short length = (orientation_ == Orientations::VERTICAL) ? dimensions->y : dimensions->x;
+		if (length != mask_size_) {
+			delete [] mask_;
+			mask_ = new unsigned char[length];
+			mask_size_ = length;
+		}
+
 		if (orientation_ == Orientations::VERTICAL) {
-			for (unsigned short x = 0; x < section->get_dimensions()->x; x++) {
-				for (unsigned short y = 0; y < section->get_dimensions()->y; y++) {
-					if (Utility::rand(255) <= threshold_) {
+			for (unsigned short x = 0; x < dimensions->x; x++) {
+				random_.fill_mask(mask_, length, threshold_);
+				for (unsigned short y = 0; y < dimensions->y; y++) {
+					if (mask_[y]) {
 						section->set_one(x, y, get_color_at_index(y));
 					}
 					else {
@@ -36,9 +46,10 @@ namespace PixelMaestro {
 			}
 		}
 		else {	// Horizontal
-			for (unsigned short y = 0; y < section->get_dimensions()->y; y++) {
-				for (unsigned short x = 0; x < section->get_dimensions()->x; x++) {
-					if (Utility::rand(255) <= threshold_) {
+			for (unsigned short y = 0; y < dimensions->y; y++) {
+				random_.fill_mask(mask_, length, threshold_);
+				for (unsigned short x = 0; x < dimensions->x; x++) {
+					if (mask_[x]) {
 						section->set_one(x, y, get_color_at_index(x));
 					}
 					else {
@@ -48,5 +59,8 @@ namespace PixelMaestro {
 			}
 		}
 	}
-}
 
+	SparkleAnimation::~SparkleAnimation() {
+		delete [] mask_;
+	}
+}
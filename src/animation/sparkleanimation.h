@@ -7,11 +7,18 @@ namespace PixelMaestro {
 	class SparkleAnimation : public Animation {
 		public:
 			SparkleAnimation(Colors::RGB* colors = nullptr, unsigned char num_colors = 0, unsigned short speed = 100, unsigned short pause = 0, unsigned char threshold = 25);
+			~SparkleAnimation();
 			unsigned char get_threshold();
 			void set_threshold(unsigned char threshold);
 			void update(Section* section);
 
 		private:
+			/// Marks which Pixels in the current row (or column, if vertical) turn on. Filled once per row.
+			unsigned char* mask_ = nullptr;
+
+			/// The number of entries in mask_.
+			unsigned short mask_size_ = 0;
+
 			/**
 			 * Threshold for activating a Pixel (0 - 100).
 			 * The higher the threshold, the more likely a Pixel will be activated.
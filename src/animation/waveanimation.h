@@ -1,13 +1,15 @@
 #ifndef WAVEANIMATION_H
 #define WAVEANIMATION_H
 
-#include "animation.h"
+#include "indexmapanimation.h"
 
 namespace PixelMaestro {
-	class WaveAnimation : public Animation {
+	class WaveAnimation : public IndexMapAnimation {
 		public:
 			WaveAnimation(Colors::RGB* colors = nullptr, unsigned char num_colors = 0, unsigned short speed = 100, unsigned short pause = 0);
-			void update(Section* section);
+
+		protected:
+			int get_map_index(Section* section, unsigned short x, unsigned short y);
 	};
 }
 
@@ -15,12 +15,70 @@ namespace PixelMaestro {
 		initialize_pattern();
 	}
 
+	/**
+	 * Blends the Canvas over a Pixel's color (COLOR mode only).
+	 * If the Pixel isn't drawn, the color is left unchanged.
+	 * @param index Index of the Pixel in the Section's Pixel grid.
+	 * @param color The color to blend over.
+	 */
+	void Canvas::blend_pixel(unsigned int index, Colors::RGB* color) {
+		PixelColor* pixel_color = get_pattern_color(index);
+		if (pixel_color == nullptr || pixel_color->alpha == 0) {
+			return;
+		}
+
+		// Opaque Pixels replace the color. Otherwise, alpha is used as the blend weight.
+		if (pixel_color->alpha == 255) {
+			*color = pixel_color->color;
+		}
+		else {
+			*color = Colors::interpolate(color, &pixel_color->color, (unsigned long)pixel_color->alpha << 8);
+		}
+	}
+
 	/**
 	 * Blanks out the Canvas (anything drawn will be lost!).
 	 */
 	void Canvas::clear() {
-		for (unsigned int pixel = 0; pixel < (unsigned int)(section_->get_dimensions()->size()); pixel++) {
-			pattern_[pixel] = false;
+		changed_ = true;
+		delete_tiles();
+	}
+
+	/**
+	 * Frees every tile, leaving the Canvas blank.
+	 */
+	void Canvas::delete_tiles() {
+		if (tiles_ == nullptr) {
+			return;
+		}
+		for (unsigned int tile = 0; tile < (unsigned int)num_tiles_x_ * num_tiles_y_; tile++) {
+			delete [] tiles_[tile];
+			tiles_[tile] = nullptr;
+			if (color_tiles_ != nullptr) {
+				delete [] color_tiles_[tile];
+				color_tiles_[tile] = nullptr;
+			}
+		}
+	}
+
+	/**
+	 * Draws a horizontal run of Pixels, clipped to the Canvas.
+	 * @param y The row to draw on.
+	 * @param start_x The first column to draw.
+	 * @param end_x The last column to draw.
+	 */
+	void Canvas::draw_span(signed long y, signed long start_x, signed long end_x) {
+		if (y < 0 || y >= size_.y) {
+			return;
+		}
+		if (start_x < 0) {
+			start_x = 0;
+		}
+		if (end_x >= size_.x) {
+			end_x = size_.x - 1;
+		}
+		if (start_x <= end_x) {
+			fill_row(y, start_x, end_x - start_x + 1, true);
 		}
 	}
 
@@ -32,94 +90,221 @@ namespace PixelMaestro {
 	 * @param fill Whether to fill the circle or leave it empty.
 	 */
 	void Canvas::draw_circle(unsigned short origin_x, unsigned short origin_y, unsigned short radius, bool fill) {
-		// (x – h)^2 + (y – k)^2 = r^2
-		// r = radius, h = origin_x, k = origin_y
+		changed_ = true;
 
 		/*
-		 * First, get the min and max x-values, then the min and max y-values.
-		 * Then, create a hypothetical square using these points and iterate over each pixel in the square.
-		 * If the pixel satisfies the equation, activate it:
-		 *		(cursor.x – origin_x)^2 + (cursor.y – origin_y)^2 = radius^2
+		 * Midpoint circle algorithm.
+		 * Walk along one eighth of the circle, starting at (radius, 0) and ending at the diagonal. The error term tracks whether the next Pixel is inside or outside the circle, so only addition is needed.
+		 * Each step is mirrored into the other seven octants.
 		 */
-		Point cursor = { 0, 0 };
-		unsigned int test_point; // Placeholder for calculating points along the circle line
-		unsigned int radius_squared = Utility::square(radius);
-		for (cursor.x = origin_x - radius; cursor.x <= origin_x + radius; cursor.x++) {
-			for (cursor.y = origin_y - radius; cursor.y <= origin_y + radius; cursor.y++) {
-				if (in_bounds(&cursor)) {
-					// Check that cursor_x and cursor_y satisfy the equation
-					test_point = Utility::square(cursor.x - origin_x) + Utility::square(cursor.y - origin_y);
-					/*
-					 * Check if the test point lies along the line.
-					 * We use radius as a sort of tolerance, otherwise only a few pixels would activate.
-					 * Or, if fill is enabled, check to see if the point lies inside the circle
-					 */
-					if ((test_point >= radius_squared - radius && test_point <= radius_squared + radius) ||
-						(fill && test_point < Utility::square(radius))) {
-						this->pattern_[section_->get_pixel_index(&cursor)] = 1;
-					}
-				}
+		signed long x = radius;
+		signed long y = 0;
+		signed long error = 1 - x;
+		while (x >= y) {
+			if (fill) {
+				draw_span(origin_y + y, origin_x - x, origin_x + x);
+				draw_span(origin_y - y, origin_x - x, origin_x + x);
+				draw_span(origin_y + x, origin_x - y, origin_x + y);
+				draw_span(origin_y - x, origin_x - y, origin_x + y);
+			}
+			else {
+				plot(origin_x + x, origin_y + y);
+				plot(origin_x - x, origin_y + y);
+				plot(origin_x + x, origin_y - y);
+				plot(origin_x - x, origin_y - y);
+				plot(origin_x + y, origin_y + x);
+				plot(origin_x - y, origin_y + x);
+				plot(origin_x + y, origin_y - x);
+				plot(origin_x - y, origin_y - x);
+			}
+
+			y++;
+			if (error < 0) {
+				error += (2 * y) + 1;
+			}
+			else {
+				x--;
+				error += (2 * (y - x)) + 1;
 			}
 		}
 	}
 
 	/**
-	 * Draws a line.
-	 * @param cursor_x Starting point x coordinate.
-	 * @param cursor_y Starting point y coordinate.
+	 * Draws an ellipse.
+	 * @param origin_x Center x coordinate.
+	 * @param origin_y Center y coordinate.
+	 * @param radius_x The ellipse's radius along the x-axis.
+	 * @param radius_y The ellipse's radius along the y-axis.
+	 * @param fill Whether to fill the ellipse or leave it empty.
+	 */
+	void Canvas::draw_ellipse(unsigned short origin_x, unsigned short origin_y, unsigned short radius_x, unsigned short radius_y, bool fill) {
+		changed_ = true;
+
+		/*
+		 * Midpoint ellipse algorithm.
+		 * Walk along one quarter of the ellipse from (-radius_x, 0) to (0, radius_y), stepping along x, y, or both depending on which keeps the error term closest to 0.
+		 * Each step is mirrored into the other three quadrants.
+		 * See "A Rasterizing Algorithm for Drawing Curves" by Alois Zingl.
+		 * The error terms grow with radius_x * radius_y * radius_y, which overflows 32 bits once both radii pass about 1000, so they use 64 bits.
+		 */
+		signed long x = -(signed long)radius_x;
+		signed long y = 0;
+		signed long long radius_x_squared = (signed long long)radius_x * radius_x;
+		signed long long radius_y_squared = (signed long long)radius_y * radius_y;
+		signed long long error = (x * ((2 * radius_y_squared) + x)) + radius_y_squared;
+		signed long long double_error;
+		do {
+			if (fill) {
+				draw_span(origin_y + y, origin_x + x, origin_x - x);
+				draw_span(origin_y - y, origin_x + x, origin_x - x);
+			}
+			else {
+				plot(origin_x - x, origin_y + y);
+				plot(origin_x + x, origin_y + y);
+				plot(origin_x + x, origin_y - y);
+				plot(origin_x - x, origin_y - y);
+			}
+
+			double_error = 2 * error;
+			if (double_error >= ((x * 2) + 1) * radius_y_squared) {
+				x++;
+				error += ((x * 2) + 1) * radius_y_squared;
+			}
+			if (double_error <= ((y * 2) + 1) * radius_x_squared) {
+				y++;
+				error += ((y * 2) + 1) * radius_x_squared;
+			}
+		} while (x <= 0);
+
+		// Very flat ellipses reach x = 0 early, so finish the tips.
+		while (y++ < radius_y) {
+			plot(origin_x, origin_y + y);
+			plot(origin_x, origin_y - y);
+		}
+	}
+
+	/**
+	 * Draws a line. Both end points are included.
+	 * @param origin_x Starting point x coordinate.
+	 * @param origin_y Starting point y coordinate.
 	 * @param target_x Ending point x coordinate.
 	 * @param target_y Ending point y coordinate.
 	 */
 	void Canvas::draw_line(unsigned short origin_x, unsigned short origin_y, unsigned short target_x, unsigned short target_y) {
-		// Calculate slope
-		float slope;
-		if (target_x == origin_x) {
-			slope = 1;
-		}
-		else if (target_y == origin_y) {
-			slope = 0;
+		changed_ = true;
+
+		/*
+		 * Bresenham's line algorithm.
+		 * Step the cursor towards the target one Pixel at a time. The error term tracks how far the cursor is from the ideal line, and decides whether to step along x, y, or both.
+		 */
+		signed long x = origin_x;
+		signed long y = origin_y;
+		signed long delta_x = (origin_x < target_x) ? target_x - origin_x : origin_x - target_x;
+		signed long delta_y = -((origin_y < target_y) ? target_y - origin_y : origin_y - target_y);
+		signed char step_x = (origin_x < target_x) ? 1 : -1;
+		signed char step_y = (origin_y < target_y) ? 1 : -1;
+		signed long error = delta_x + delta_y;
+		signed long double_error;
+		while (true) {
+			plot(x, y);
+			if (x == target_x && y == target_y) {
+				break;
+			}
+
+			double_error = 2 * error;
+			if (double_error >= delta_y) {
+				error += delta_y;
+				x += step_x;
+			}
+			if (double_error <= delta_x) {
+				error += delta_x;
+				y += step_y;
+			}
 		}
-		else {
-			slope = (target_y - origin_y) / (float)(target_x - origin_x);
+	}
+
+	/**
+	 * Draws a polygon by connecting each point to the next, and the last point to the first.
+	 * Filled polygons use the even-odd rule, so areas where the polygon overlaps itself an even number of times are left empty.
+	 * @param points The polygon's corners.
+	 * @param num_points The number of corners.
+	 * @param fill Whether to fill the polygon or leave it empty.
+	 */
+	void Canvas::draw_polygon(Point* points, unsigned short num_points, bool fill) {
+		changed_ = true;
+		if (num_points == 0) {
+			return;
 		}
 
-		Point cursor = { origin_x, origin_y };
+		// Draw the outline.
+		for (unsigned short point = 0; point < num_points; point++) {
+			Point* next = &points[(point + 1) % num_points];
+			draw_line(points[point].x, points[point].y, next->x, next->y);
+		}
 
-		// Handle vertical lines
-		if (target_x == origin_x) {
-			while (cursor.y != target_y) {
-				if (in_bounds(&cursor)) {
-					this->pattern_[section_->get_pixel_index(&cursor)] = 1;
-				}
+		if (!fill || num_points < 3) {
+			return;
+		}
 
-				if (target_y >= cursor.y) {
-					cursor.y++;
-				}
-				else {
-					cursor.y--;
-				}
+		// Only scan rows that the polygon covers.
+		unsigned short min_y = points[0].y;
+		unsigned short max_y = points[0].y;
+		for (unsigned short point = 1; point < num_points; point++) {
+			if (points[point].y < min_y) {
+				min_y = points[point].y;
+			}
+			if (points[point].y > max_y) {
+				max_y = points[point].y;
 			}
 		}
-		else {
-			float y_intercept = (slope * origin_x) - origin_y;
-			/*
-			 * Move the cursor along the x-axis.
-			 * For each x-coordinate, apply the slope and round the y-value to the nearest integer.
-			 */
-			while (cursor.x != target_x) {
-				if (in_bounds(&cursor)) {
-					this->pattern_[section_->get_pixel_index(&cursor)] = 1;
-				}
+		if (max_y >= size_.y) {
+			max_y = size_.y - 1;
+		}
 
-				if (target_x >= origin_x) {
-					cursor.x++;
+		/*
+		 * Scanline fill.
+		 * For each row, find where the row crosses the polygon's edges, sort the crossings, then fill between each pair of crossings.
+		 * Crossings are stored in 1/256ths of a Pixel. An edge covers the rows from its top end up to, but not including, its bottom end, so shared corners are only counted once. The outline covers the edges themselves.
+		 */
+		signed long* crossings = new signed long[num_points];
+		for (signed long y = min_y; y <= max_y; y++) {
+			unsigned short num_crossings = 0;
+			for (unsigned short point = 0; point < num_points; point++) {
+				Point* start = &points[point];
+				Point* end = &points[(point + 1) % num_points];
+				if (start->y > end->y) {
+					Point* temp = start;
+					start = end;
+					end = temp;
 				}
-				else {
-					cursor.x--;
+				if (y < start->y || y >= end->y) {
+					continue;
 				}
-				cursor.y = (slope * (float)cursor.x) - y_intercept;
+
+				/*
+					Interpolate the crossing in two parts to avoid overflowing.
+					The run can reach 65535 * 65535, so it needs 64 bits. Dividing it by the rise brings it back within the Canvas.
+				*/
+				signed long rise = end->y - start->y;
+				signed long long run = (y - start->y) * ((signed long long)end->x - start->x);
+				signed long crossing = ((signed long)start->x * 256) + ((signed long)(run / rise) * 256) + (((signed long)(run % rise) * 256) / rise);
+
+				// Insertion sort, since there are usually only two crossings.
+				unsigned short index = num_crossings;
+				while (index > 0 && crossings[index - 1] > crossing) {
+					crossings[index] = crossings[index - 1];
+					index--;
+				}
+				crossings[index] = crossing;
+				num_crossings++;
+			}
+
+			// Fill the Pixels between each pair of crossings.
+			for (unsigned short crossing = 0; crossing + 1 < num_crossings; crossing += 2) {
+				draw_span(y, (crossings[crossing] + 255) / 256, crossings[crossing + 1] / 256);
 			}
 		}
+		delete [] crossings;
 	}
 
 	/**
@@ -128,8 +313,9 @@ namespace PixelMaestro {
 	 * @param cursor_y Starting point y coordinate.
 	 */
 	void Canvas::draw_point(unsigned short x, unsigned short y) {
+		changed_ = true;
 		if (in_bounds(x, y)) {
-			pattern_[section_->get_pixel_index(x, y)] = 1;
+			set_point(x, y, true);
 		}
 	}
 
@@ -142,32 +328,27 @@ namespace PixelMaestro {
 	 * @param fill Whether to fill the rectangle or leave it empty.
 	 */
 	void Canvas::draw_rect(unsigned short origin_x, unsigned short origin_y, unsigned short size_x, unsigned short size_y, bool fill) {
-		Point cursor = { origin_x, origin_y };
-		for (unsigned short column = 0; column < size_x; column++) {
-			// (Re-)Initialize cursor coordinates.
-			cursor.x = origin_x + column;
-			cursor.y = origin_y;
-			for (unsigned short row = 0; row < size_y; row++) {
-				cursor.y = origin_y + row;
-				if (in_bounds(&cursor)) {
-					// Check whether to fill
-					if (fill) {
-						this->pattern_[section_->get_pixel_index(&cursor)] = 1;
-					}
-					else {
-						/*
-						 * Only draw if the cursor is at the border of the rectangle.
-						 * We do this by checking to see if the cursor is either horizontally or vertically aligned with the starting or end point.
-						 */
-						if ((cursor.x == origin_x || cursor.y == origin_y) ||
-							(column == size_x - 1 || row == size_y - 1)) {
-							this->pattern_[section_->get_pixel_index(&cursor)] = 1;
-						}
-						else {
-							// Don't fill.
-							continue;
-						}
-					}
+		changed_ = true;
+
+		// Clip the rectangle to the Canvas.
+		if (size_x == 0 || size_y == 0 || origin_x >= size_.x || origin_y >= size_.y) {
+			return;
+		}
+		unsigned int end_x = origin_x + size_x;
+		unsigned int end_y = origin_y + size_y;
+		unsigned short width = ((end_x < size_.x) ? end_x : size_.x) - origin_x;
+		unsigned short last_row = ((end_y < size_.y) ? end_y : size_.y) - 1;
+
+		// Each row of the rectangle is a contiguous run of bits, so it can be set a word at a time.
+		for (unsigned short row = origin_y; row <= last_row; row++) {
+			if (fill || row == origin_y || row == end_y - 1) {
+				fill_row(row, origin_x, width, true);
+			}
+			else {
+				// Only draw the left and right borders.
+				set_point(origin_x, row, true);
+				if (end_x <= size_.x) {
+					set_point(end_x - 1, row, true);
 				}
 			}
 		}
@@ -181,6 +362,7 @@ namespace PixelMaestro {
 	 * @param text The string to render.
 	 */
 	void Canvas::draw_text(unsigned short origin_x, unsigned short origin_y, Font* font, const char* text) {
+		changed_ = true;
 		Point cursor = {origin_x, origin_y};
 
 		unsigned char* current_char;
@@ -196,8 +378,8 @@ namespace PixelMaestro {
 			current_char = font->get_char(text[letter]);
 			for (int column = 0; column < font->size.x; column++) {
 				for (int row = 0; row < font->size.y; row++) {
-					if (in_bounds(&cursor)) {
-						pattern_[section_->get_pixel_index(cursor.x + column, cursor.y + row)] = (current_char[column] >> row) & 1;
+					if (in_bounds(cursor.x + column, cursor.y + row)) {
+						set_point(cursor.x + column, cursor.y + row, (current_char[column] >> row) & 1);
 					}
 					else {
 						break;
@@ -212,7 +394,7 @@ namespace PixelMaestro {
 	}
 
 	/**
-	 * Draws a triangle. Points are drawn in a clockwise manner.
+	 * Draws a triangle.
 	 * @param point_a_x First point x-coordinate.
 	 * @param point_a_y First point y-coordinate.
 	 * @param point_b_x Second point x-coordinate.
@@ -222,32 +404,12 @@ namespace PixelMaestro {
 	 * @param fill Whether to fill the triangle or leave it empty.
 	 */
 	void Canvas::draw_triangle(unsigned short point_a_x, unsigned short point_a_y, unsigned short point_b_x, unsigned short point_b_y, unsigned short point_c_x, unsigned short point_c_y, bool fill) {
-		this->draw_line(point_a_x, point_a_y, point_b_x, point_b_y);
-		this->draw_line(point_b_x, point_b_y, point_c_x, point_c_y);
-		this->draw_line(point_c_x, point_c_y, point_a_x, point_a_y);
-
-		if (fill) {
-			/*
-			 * This uses barycentric coordinates to check whether the cursor is inside the triangle.
-			 * https://en.wikipedia.org/wiki/Barycentric_coordinate_system_(mathematics)
-			 * https://stackoverflow.com/questions/2049582/how-to-determine-if-a-point-is-in-a-2d-triangle
-			 */
-			Point cursor = { 0, 0 };
-			float area, s, t;
-			area = 0.5 *(-point_b_y*point_c_x + point_a_y*(-point_b_x + point_c_x) + point_a_x*(point_b_y - point_c_y) + point_b_x*point_c_y);
-
-			// TODO: Until I find a more efficient way to do this, we're just gonna iterate through each pixel in the grid.
-			for (cursor.x = 0; cursor.x < section_->get_dimensions()->x; cursor.x++) {
-				for (cursor.y = 0; cursor.y < section_->get_dimensions()->y; cursor.y++) {
-					s = 1/(2*area)*(point_a_y*point_c_x - point_a_x*point_c_y + (point_c_y - point_a_y)*cursor.x + (point_a_x - point_c_x)*cursor.y);
-					t = 1/(2*area)*(point_a_x*point_b_y - point_a_y*point_b_x + (point_a_y - point_b_y)*cursor.x + (point_b_x - point_a_x)*cursor.y);
-
-					if (s > 0 && t > 0 && 1-s-t > 0) {
-						this->pattern_[section_->get_pixel_index(&cursor)] = 1;
-					}
-				}
-			}
-		}
+		Point points[] = {
+			{point_a_x, point_a_y},
+			{point_b_x, point_b_y},
+			{point_c_x, point_c_y}
+		};
+		draw_polygon(points, 3, fill);
 	}
 
 	/**
@@ -256,16 +418,354 @@ namespace PixelMaestro {
 	 * @param cursor_y The pixel's y-coordinate.
 	 */
 	void Canvas::erase(unsigned short x, unsigned short y) {
-		pattern_[section_->get_pixel_index(x, y)] = 0;
+		changed_ = true;
+		if (in_bounds(x, y)) {
+			set_point(x, y, false);
+		}
+	}
+
+	/**
+	 * Draws every Pixel in the Canvas.
+	 */
+	void Canvas::fill() {
+		for (unsigned short row = 0; row < size_.y; row++) {
+			fill_row(row, 0, size_.x, true);
+		}
 	}
 
 	/**
-	 * Returns the boolean value at the specified index.
+	 * Sets or clears a run of Pixels in a row, a word at a time. The run is clipped to the Canvas.
+	 * @param y The row to change.
+	 * @param x The first column to change.
+	 * @param length Number of Pixels.
+	 * @param value True to draw the Pixels, false to erase them.
+	 */
+	void Canvas::fill_row(unsigned short y, unsigned short x, unsigned short length, bool value) {
+		changed_ = true;
+		if (y >= size_.y || x >= size_.x) {
+			return;
+		}
+		unsigned int end = (unsigned int)x + length;
+		if (end > size_.x) {
+			end = size_.x;
+		}
+
+		unsigned int start = x;
+		unsigned char bit;
+		unsigned int num_bits;
+		unsigned long mask;
+		unsigned long* tile;
+		while (start < end) {
+			// Cover as much of the current word as possible.
+			bit = start % WORD_BITS;
+			num_bits = WORD_BITS - bit;
+			if (num_bits > end - start) {
+				num_bits = end - start;
+			}
+			mask = (num_bits == WORD_BITS) ? ~0UL : (((1UL << num_bits) - 1) << bit);
+
+			// Erasing a blank tile doesn't need to allocate it.
+			tile = get_tile(start / WORD_BITS, y / TILE_HEIGHT, value);
+			if (tile != nullptr) {
+				if (value) {
+					tile[y % TILE_HEIGHT] |= mask;
+				}
+				else {
+					tile[y % TILE_HEIGHT] &= ~mask;
+				}
+			}
+			start += num_bits;
+		}
+
+		if (value && mode_ == Mode::COLOR) {
+			for (start = x; start < end; start++) {
+				paint(start, y);
+			}
+		}
+	}
+
+	/**
+	 * Returns the color used for drawing in COLOR mode.
+	 * @return Drawing color.
+	 */
+	Canvas::PixelColor* Canvas::get_drawing_color() {
+		return &drawing_color_;
+	}
+
+	/**
+	 * Returns how the Canvas displays its pattern.
+	 * @return Canvas mode.
+	 */
+	Canvas::Mode Canvas::get_mode() {
+		return mode_;
+	}
+
+	/**
+	 * Returns the number of drawn Pixels.
+	 * @return Number of drawn Pixels.
+	 */
+	unsigned int Canvas::get_num_drawn() {
+		unsigned int count = 0;
+		if (tiles_ == nullptr) {
+			return count;
+		}
+		for (unsigned int tile = 0; tile < (unsigned int)num_tiles_x_ * num_tiles_y_; tile++) {
+			if (tiles_[tile] == nullptr) {
+				continue;
+			}
+			for (unsigned char row = 0; row < TILE_HEIGHT; row++) {
+#if defined(__GNUC__)
+				count += __builtin_popcountl(tiles_[tile][row]);
+#else
+				for (unsigned long bits = tiles_[tile][row]; bits != 0; bits &= bits - 1) {
+					count++;
+				}
+#endif
+			}
+		}
+		return count;
+	}
+
+	/**
+	 * Returns the color of the Pixel at the specified index (COLOR mode only).
+	 * The index refers to the Section's Pixel grid, so the Canvas offset is applied.
+	 * @param index Index to retrieve.
+	 * @return Pixel color, or nullptr if the Pixel isn't drawn.
+	 */
+	Canvas::PixelColor* Canvas::get_pattern_color(unsigned int index) {
+		unsigned short x, y;
+		if (mode_ != Mode::COLOR || !get_source(index, &x, &y)) {
+			return nullptr;
+		}
+
+		unsigned int tile = ((unsigned int)(y / TILE_HEIGHT) * num_tiles_x_) + (x / WORD_BITS);
+		if (tiles_[tile] == nullptr || ((tiles_[tile][y % TILE_HEIGHT] >> (x % WORD_BITS)) & 1) == 0) {
+			return nullptr;
+		}
+		return &color_tiles_[tile][((y % TILE_HEIGHT) * WORD_BITS) + (x % WORD_BITS)];
+	}
+
+	/**
+	 * Returns whether the Pixel at the specified index is drawn.
+	 * The index refers to the Section's Pixel grid, so the Canvas offset is applied.
 	 * @param index Index to retrieve.
 	 * @return True if drawn, false if not.
 	 */
 	bool Canvas::get_pattern_index(unsigned int index) {
-		return pattern_[index];
+		unsigned short width = section_->get_dimensions()->x;
+		return get_row_span(index / width, index % width, 1);
+	}
+
+	/**
+	 * Returns whether each Pixel in a run of WORD_BITS Pixels is drawn.
+	 * Bit n of the result corresponds to Pixel (start + n) in the Section's Pixel grid, with the Canvas offset applied. Pixels past the end of the Section are returned as not drawn.
+	 * @param start Index of the first Pixel.
+	 * @return Mask of drawn Pixels.
+	 */
+	unsigned long Canvas::get_pattern_span(unsigned int start) {
+		// The Canvas and the Section can have different widths, so build the mask one row segment at a time.
+		Point* dimensions = section_->get_dimensions();
+		unsigned int size = dimensions->size();
+		unsigned long mask = 0;
+		unsigned char num_bits = 0;
+		unsigned short x, count;
+		while (num_bits < WORD_BITS && start < size) {
+			x = start % dimensions->x;
+			count = dimensions->x - x;
+			if (count > WORD_BITS - num_bits) {
+				count = WORD_BITS - num_bits;
+			}
+			mask |= get_row_span(start / dimensions->x, x, count) << num_bits;
+			num_bits += count;
+			start += count;
+		}
+		return mask;
+	}
+
+	/**
+	 * Returns part of a row of the Section's Pixel grid, with the Canvas offset applied.
+	 * The pattern isn't moved: the offset is applied by reading from a different place in the pattern. If scrolling repeats, reads wrap around the edges of the pattern.
+	 * @param y The row to read.
+	 * @param x The first column to read.
+	 * @param count The number of Pixels to read (up to WORD_BITS). Must not go past the end of the row.
+	 * @return Mask of drawn Pixels.
+	 */
+	unsigned long Canvas::get_row_span(unsigned short y, unsigned short x, unsigned char count) {
+		if (size_.x == 0 || size_.y == 0) {
+			return 0;
+		}
+		bool repeat = (scroll_ != nullptr && scroll_->repeat);
+
+		// Find where the Pixels come from in the pattern.
+		signed long source_x = (signed long)x - offset_x_;
+		signed long source_y = (signed long)y - offset_y_;
+		if (repeat) {
+			source_x %= size_.x;
+			if (source_x < 0) {
+				source_x += size_.x;
+			}
+			source_y %= size_.y;
+			if (source_y < 0) {
+				source_y += size_.y;
+			}
+		}
+		else if (source_y < 0 || source_y >= size_.y) {
+			return 0;
+		}
+
+		unsigned long mask = 0;
+		unsigned char num_bits = 0;
+		unsigned long length;
+		while (num_bits < count) {
+			// Without repeating, Pixels before the start of the pattern aren't drawn.
+			if (source_x < 0) {
+				length = -source_x;
+				if (length > (unsigned long)(count - num_bits)) {
+					length = count - num_bits;
+				}
+				num_bits += length;
+				source_x += length;
+				continue;
+			}
+
+			// Without repeating, Pixels past the end of the pattern aren't drawn.
+			if (source_x >= size_.x) {
+				break;
+			}
+
+			// Copy as much of the pattern row as possible.
+			length = size_.x - source_x;
+			if (length > (unsigned long)(count - num_bits)) {
+				length = count - num_bits;
+			}
+			unsigned long bits = get_stored_span(source_x, source_y);
+			if (length < WORD_BITS) {
+				bits &= (1UL << length) - 1;
+			}
+			mask |= bits << num_bits;
+			num_bits += length;
+			source_x += length;
+
+			if (repeat && source_x == size_.x) {
+				source_x = 0;
+			}
+		}
+
+		return mask;
+	}
+
+	/**
+	 * Finds the Pixel in the pattern that's shown at the specified index of the Section's Pixel grid.
+	 * @param index Index of the Pixel in the Section's Pixel grid.
+	 * @param x Set to the Pixel's x-coordinate in the pattern.
+	 * @param y Set to the Pixel's y-coordinate in the pattern.
+	 * @return True if the Pixel is in the pattern, false if it falls outside of the Canvas.
+	 */
+	bool Canvas::get_source(unsigned int index, unsigned short* x, unsigned short* y) {
+		if (size_.x == 0 || size_.y == 0) {
+			return false;
+		}
+
+		unsigned short width = section_->get_dimensions()->x;
+		signed long source_x = (signed long)(index % width) - offset_x_;
+		signed long source_y = (signed long)(index / width) - offset_y_;
+		if (scroll_ != nullptr && scroll_->repeat) {
+			source_x %= size_.x;
+			if (source_x < 0) {
+				source_x += size_.x;
+			}
+			source_y %= size_.y;
+			if (source_y < 0) {
+				source_y += size_.y;
+			}
+		}
+		else if (source_x < 0 || source_x >= size_.x || source_y < 0 || source_y >= size_.y) {
+			return false;
+		}
+
+		*x = source_x;
+		*y = source_y;
+		return true;
+	}
+
+	/**
+	 * Returns WORD_BITS Pixels from a row of the pattern, ignoring the offset.
+	 * Pixels past the end of the row are returned as not drawn.
+	 * @param x The first column to read.
+	 * @param y The row to read.
+	 * @return Mask of drawn Pixels.
+	 */
+	unsigned long Canvas::get_stored_span(unsigned short x, unsigned short y) {
+		unsigned short tile_x = x / WORD_BITS;
+		unsigned short tile_y = y / TILE_HEIGHT;
+		unsigned char row = y % TILE_HEIGHT;
+		unsigned char bit = x % WORD_BITS;
+
+		unsigned long* tile = get_tile(tile_x, tile_y, false);
+		unsigned long bits = (tile != nullptr) ? tile[row] : 0;
+		if (bit == 0) {
+			return bits;
+		}
+
+		// The span continues into the next tile.
+		bits >>= bit;
+		if (tile_x + 1 < num_tiles_x_) {
+			tile = get_tile(tile_x + 1, tile_y, false);
+			if (tile != nullptr) {
+				bits |= tile[row] << (WORD_BITS - bit);
+			}
+		}
+		return bits;
+	}
+
+	/**
+	 * Returns the tile at the specified tile coordinates.
+	 * @param tile_x The tile's column.
+	 * @param tile_y The tile's row.
+	 * @param allocate If true, allocate the tile if it's blank.
+	 * @return Tile, or nullptr if the tile is blank and allocate is false.
+	 */
+	unsigned long* Canvas::get_tile(unsigned short tile_x, unsigned short tile_y, bool allocate) {
+		unsigned int tile = ((unsigned int)tile_y * num_tiles_x_) + tile_x;
+		if (tiles_[tile] == nullptr && allocate) {
+			tiles_[tile] = new unsigned long[TILE_HEIGHT]();
+		}
+		return tiles_[tile];
+	}
+
+	/**
+	 * Returns the time until the Canvas next changes, either by scrolling or because it was drawn on since the last update.
+	 * @param current_time The program's current runtime.
+	 * @return Time until the next change (in ms), 0 if a change is due, or the longest possible time if the Canvas won't change on its own.
+	 */
+	unsigned long Canvas::get_time_until_change(const unsigned long& current_time) {
+		if (changed_) {
+			return 0;
+		}
+
+		unsigned long time = (unsigned long)-1;
+		if (scroll_ != nullptr) {
+			// Scroll intervals are measured in refreshes (see scroll_axis()).
+			unsigned long refresh_interval = section_->get_refresh_interval();
+			if (scroll_->interval_x != 0) {
+				time = Utility::time_remaining(scroll_->last_scroll_x, Utility::abs_int(scroll_->interval_x) * refresh_interval, current_time);
+			}
+			if (scroll_->interval_y != 0) {
+				unsigned long time_y = Utility::time_remaining(scroll_->last_scroll_y, Utility::abs_int(scroll_->interval_y) * refresh_interval, current_time);
+				if (time_y < time) {
+					time = time_y;
+				}
+			}
+		}
+		return time;
+	}
+
+	/**
+	 * Returns the Canvas' scrolling behavior.
+	 * @return Scrolling behavior, or nullptr if the Canvas isn't scrolling.
+	 */
+	Canvas::Scroll* Canvas::get_scroll() {
+		return scroll_;
 	}
 
 	/**
@@ -276,6 +776,14 @@ namespace PixelMaestro {
 		return section_;
 	}
 
+	/**
+	 * Returns the size of the Canvas.
+	 * @return Canvas size.
+	 */
+	Point* Canvas::get_size() {
+		return &size_;
+	}
+
 	/**
 	 * Returns whether the given Point is in the bounds of the Canvas.
 	 * @param point The Point to check.
@@ -292,27 +800,86 @@ namespace PixelMaestro {
 	 * @return Whether the Point is in bounds.
 	 */
 	bool Canvas::in_bounds(unsigned short x, unsigned short y) {
-		return (x < section_->get_dimensions()->x) && (y < section_->get_dimensions()->y);
+		return (x < size_.x) && (y < size_.y);
+	}
+
+	/**
+	 * Sets a Pixel to the drawing color (COLOR mode only).
+	 * @param x The Pixel's x-coordinate.
+	 * @param y The Pixel's y-coordinate.
+	 */
+	void Canvas::paint(unsigned short x, unsigned short y) {
+		unsigned int tile = ((unsigned int)(y / TILE_HEIGHT) * num_tiles_x_) + (x / WORD_BITS);
+		if (color_tiles_[tile] == nullptr) {
+			color_tiles_[tile] = new PixelColor[WORD_BITS * TILE_HEIGHT]();
+		}
+		color_tiles_[tile][((y % TILE_HEIGHT) * WORD_BITS) + (x % WORD_BITS)] = drawing_color_;
+	}
+
+	/**
+	 * Draws a single Pixel if it's inside the Canvas.
+	 * @param x The Pixel's x-coordinate.
+	 * @param y The Pixel's y-coordinate.
+	 */
+	void Canvas::plot(signed long x, signed long y) {
+		if (x >= 0 && y >= 0 && x < size_.x && y < size_.y) {
+			set_point(x, y, true);
+		}
 	}
 
 	/**
-	 * Reinitializes the pattern array.
+	 * Reinitializes the pattern, which blanks out the Canvas.
+	 * Unless the Canvas has its own size (see set_size()), it's resized to match the Section.
 	 */
 	void Canvas::initialize_pattern() {
-		// Initialize the pattern
-		if (pattern_ != nullptr) {
-			delete pattern_;
+		changed_ = true;
+		if (!custom_size_) {
+			size_ = *section_->get_dimensions();
+		}
+
+		// Tiles are allocated as they're drawn on, so only the tile tables are allocated here.
+		delete_tiles();
+		delete [] tiles_;
+		delete [] color_tiles_;
+		color_tiles_ = nullptr;
+		num_tiles_x_ = (size_.x + WORD_BITS - 1) / WORD_BITS;
+		num_tiles_y_ = (size_.y + TILE_HEIGHT - 1) / TILE_HEIGHT;
+		tiles_ = new unsigned long*[(unsigned int)num_tiles_x_ * num_tiles_y_]();
+		if (mode_ == Mode::COLOR) {
+			color_tiles_ = new PixelColor*[(unsigned int)num_tiles_x_ * num_tiles_y_]();
 		}
-		pattern_ = new bool[section_->get_dimensions()->size()] {0};
 	}
 
 	/**
 	 * Deletes this Canvas' scrolling behavior.
 	 */
 	void Canvas::remove_scroll() {
-		if (scroll_ != nullptr) {
-			delete scroll_;
+		delete scroll_;
+		scroll_ = nullptr;
+		changed_ = true;
+	}
+
+	/**
+	 * Sets the color used for drawing in COLOR mode.
+	 * Only Pixels drawn after calling this use the new color.
+	 * @param color Drawing color.
+	 * @param alpha How opaque the drawn Pixels are, from 0 (transparent) to 255 (opaque).
+	 */
+	void Canvas::set_drawing_color(Colors::RGB* color, unsigned char alpha) {
+		drawing_color_.color = *color;
+		drawing_color_.alpha = alpha;
+	}
+
+	/**
+	 * Sets how the Canvas displays its pattern. Changing the mode blanks out the Canvas.
+	 * @param mode New mode.
+	 */
+	void Canvas::set_mode(Mode mode) {
+		if (mode == mode_) {
+			return;
 		}
+		mode_ = mode;
+		initialize_pattern();
 	}
 
 	/**
@@ -322,6 +889,7 @@ namespace PixelMaestro {
 	 * @param y Offset along the y-axis.
 	 */
 	void Canvas::set_offset(signed short x, signed short y) {
+		changed_ = true;
 		offset_x_ = x;
 		offset_y_ = y;
 	}
@@ -331,21 +899,64 @@ namespace PixelMaestro {
 	 * Note: This can't be used in combination with set_offset().
 	 * Scroll time is determined by the Section refresh rate * the scroll interval, so an interval of '5' means scrolling occurs once on that axis every 5 refreshes.
 	 * Setting an axis to 0 (default) disables scrolling on that axis.
+	 * Each time an axis scrolls, it moves by its step. Steps are measured in 1/256ths of a Pixel, so the Canvas can scroll by fractions of a Pixel (e.g. 128 scrolls 1 Pixel every 2 intervals) or by several Pixels at once (e.g. 512 scrolls 2 Pixels per interval).
 	 *
 	 * @param x Scrolling interval along the x-axis.
 	 * @param y Scrolling interval along the y-axis.
+	 * @param repeat If true, repeat the Canvas while scrolling.
+	 * @param step_x Distance to scroll along the x-axis each interval, in 1/256ths of a Pixel.
+	 * @param step_y Distance to scroll along the y-axis each interval, in 1/256ths of a Pixel.
 	 */
-	void Canvas::set_scroll(signed short x, signed short y, bool repeat) {
+	void Canvas::set_scroll(signed short x, signed short y, bool repeat, unsigned short step_x, unsigned short step_y) {
 		if (scroll_ == nullptr) {
-			scroll_ = new Scroll(x, y, repeat);
+			scroll_ = new Scroll(x, y, repeat, step_x, step_y);
 		}
 		else {
-			scroll_->interval_x = y;
+			scroll_->interval_x = x;
 			scroll_->interval_y = y;
 			scroll_->repeat = repeat;
+			scroll_->step_x = step_x;
+			scroll_->step_y = step_y;
+		}
+		changed_ = true;
+	}
+
+	/**
+	 * Sets or clears a single Pixel.
+	 * @param x The Pixel's x-coordinate.
+	 * @param y The Pixel's y-coordinate.
+	 * @param value True to draw the Pixel, false to erase it.
+	 */
+	void Canvas::set_point(unsigned short x, unsigned short y, bool value) {
+		// Erasing a blank tile doesn't need to allocate it.
+		unsigned long* tile = get_tile(x / WORD_BITS, y / TILE_HEIGHT, value);
+		if (tile == nullptr) {
+			return;
+		}
+		if (value) {
+			tile[y % TILE_HEIGHT] |= (1UL << (x % WORD_BITS));
+			if (mode_ == Mode::COLOR) {
+				paint(x, y);
+			}
+		}
+		else {
+			tile[y % TILE_HEIGHT] &= ~(1UL << (x % WORD_BITS));
 		}
 	}
 
+	/**
+	 * Sets the size of the Canvas, which blanks out the Canvas.
+	 * The Canvas can be larger than the Section, in which case the Section acts as a viewport into the Canvas. Use set_offset() or set_scroll() to move the viewport. Drawing is clipped to the size of the Canvas, not the Section.
+	 * Setting either axis to 0 makes the Canvas match the size of the Section (default).
+	 * @param x Width of the Canvas.
+	 * @param y Height of the Canvas.
+	 */
+	void Canvas::set_size(unsigned short x, unsigned short y) {
+		custom_size_ = (x != 0 && y != 0);
+		size_.set(x, y);
+		initialize_pattern();
+	}
+
 	/**
 	 * Changes the Canvas' parent Section.
 	 * @param section New Section.
@@ -358,73 +969,94 @@ namespace PixelMaestro {
 	/**
 	 * Redraw the Canvas.
 	 * @param current_time The program's current runtime.
+	 * @return True if the Canvas changed since the last update, meaning the parent Section needs to be redrawn.
 	 */
-	void Canvas::update(const unsigned long& current_time) {
+	bool Canvas::update(const unsigned long& current_time) {
 		if (scroll_ != nullptr) {
 			update_scroll(current_time);
 		}
+
+		bool changed = changed_;
+		changed_ = false;
+		return changed;
 	}
 
 	/**
-	 * Scrolls the Canvas by 1 increment.
-	 * @param current_time The program's current runtime).
+	 * Scrolls the Canvas if enough time has passed.
+	 * Scrolling only changes the offset. The pattern itself isn't moved or redrawn.
+	 * @param current_time The program's current runtime.
 	 */
 	void Canvas::update_scroll(const unsigned long& current_time) {
-		/*
-		 * If Canvas::scroll_interval is set, scroll the Canvas.
-		 * scroll_interval dictates how many refreshes will occur before the Canvas is scrolled.
-		 * For each axis, determine the impact of scroll_interval-><axis> and make the change.
-		 * If the axis exceeds the bounds of the Pixel grid, wrap back to the opposite side.
-		 */
 		if (scroll_ != nullptr) {
-			unsigned long target_time = current_time - scroll_->last_scroll_x;
-			if (scroll_->interval_x != 0 && (Utility::abs_int(scroll_->interval_x) * section_->get_refresh_interval()) <= target_time) {
-
-				// Increment or decrement the offset depending on the scroll direction.
-				if (scroll_->interval_x > 0) {
-					offset_x_++;
-				}
-				else if (scroll_->interval_x < 0) {
-					offset_x_--;
-				}
-
-				// Check the bounds of the parent Section.
-				if (offset_x_ >= section_->get_dimensions()->x) {
-					offset_x_ = 0;
-				}
-				else if (offset_x_ + 1 == 0) {	// Buffer overflow
-					offset_x_ = section_->get_dimensions()->x;
-				}
-
-				scroll_->last_scroll_x = current_time;
+			/*
+			 * When repeating, the Canvas wraps around itself, so the offset only needs to cover one Canvas.
+			 * Otherwise, the Canvas scrolls completely off of the Section before reappearing on the opposite side.
+			 */
+			Point* dimensions = section_->get_dimensions();
+			if (scroll_->repeat) {
+				scroll_axis(scroll_->interval_x, scroll_->step_x, &scroll_->last_scroll_x, &scroll_->remainder_x, &offset_x_, 0, size_.x, current_time);
+				scroll_axis(scroll_->interval_y, scroll_->step_y, &scroll_->last_scroll_y, &scroll_->remainder_y, &offset_y_, 0, size_.y, current_time);
 			}
+			else {
+				scroll_axis(scroll_->interval_x, scroll_->step_x, &scroll_->last_scroll_x, &scroll_->remainder_x, &offset_x_, -(signed long)size_.x, size_.x + dimensions->x, current_time);
+				scroll_axis(scroll_->interval_y, scroll_->step_y, &scroll_->last_scroll_y, &scroll_->remainder_y, &offset_y_, -(signed long)size_.y, size_.y + dimensions->y, current_time);
+			}
+		}
+	}
 
-			target_time = current_time - scroll_->last_scroll_y;
-			if (scroll_->interval_y != 0 && (Utility::abs_int(scroll_->interval_y) * section_->get_refresh_interval()) <= target_time) {
+	/**
+	 * Scrolls along one axis.
+	 * If the update is late and several intervals have passed, the Canvas moves by all of them at once.
+	 * The offset wraps around, so it always stays between min_offset and (min_offset + range).
+	 * @param interval Scrolling interval. The sign sets the direction.
+	 * @param step Distance to move each interval, in 1/256ths of a Pixel.
+	 * @param last_scroll The last time the axis scrolled.
+	 * @param remainder Distance moved but not yet applied, in 1/256ths of a Pixel.
+	 * @param offset The offset to update.
+	 * @param min_offset The lowest offset.
+	 * @param range The number of offsets before wrapping around.
+	 * @param current_time The program's current runtime.
+	 */
+	void Canvas::scroll_axis(signed short interval, unsigned short step, unsigned long* last_scroll, unsigned char* remainder, signed int* offset, signed long min_offset, unsigned long range, const unsigned long& current_time) {
+		unsigned long period = Utility::abs_int(interval) * section_->get_refresh_interval();
+		unsigned long elapsed = current_time - *last_scroll;
+		if (interval == 0 || range == 0 || elapsed < period) {
+			return;
+		}
 
-				// Increment or decrement the offset depending on the scroll direction.
-				if (scroll_->interval_y > 0) {
-					offset_y_++;
-				}
-				else if (scroll_->interval_y < 0) {
-					offset_y_--;
-				}
+		// Count the number of intervals that have passed, keeping any leftover time for the next scroll.
+		unsigned long steps = 1;
+		if (period > 0) {
+			steps = elapsed / period;
+			*last_scroll += steps * period;
+		}
+		else {
+			*last_scroll = current_time;
+		}
 
-				// Check the bounds of the parent Section.
-				if (offset_y_ >= section_->get_dimensions()->y) {
-					offset_y_ = 0;
-				}
-				else if (offset_y_ + 1 == 0) {	// Buffer overflow
-					offset_y_ = section_->get_dimensions()->y;
-				}
+		unsigned long distance = (steps * step) + *remainder;
+		*remainder = distance & 0xFF;
+		signed long pixels = (distance >> 8) % range;
+		if (pixels == 0) {
+			return;
+		}
 
-				scroll_->last_scroll_y = current_time;
-			}
+		// Move in the direction of the interval, then wrap the offset around the range.
+		if (interval < 0) {
+			pixels = -pixels;
+		}
+		signed long position = (*offset - min_offset + pixels) % (signed long)range;
+		if (position < 0) {
+			position += range;
 		}
+		*offset = min_offset + position;
+		changed_ = true;
 	}
 
 	Canvas::~Canvas() {
-		delete[] pattern_;
+		delete_tiles();
+		delete [] tiles_;
+		delete [] color_tiles_;
 		delete scroll_;
 	}
 }
@@ -15,6 +15,24 @@ namespace PixelMaestro {
 
 	class Canvas {
 		public:
+			/// The ways that a Canvas can display its pattern.
+			enum class Mode : unsigned char {
+				/// Drawn Pixels show the Section's Animation, and all other Pixels are black.
+				MASK,
+
+				/// Drawn Pixels are blended over the Section's Animation using the color they were drawn in, and all other Pixels show the Animation.
+				COLOR
+			};
+
+			/// The color of a Pixel drawn in COLOR mode.
+			struct PixelColor {
+				/// The Pixel's color.
+				Colors::RGB color;
+
+				/// How opaque the Pixel is, from 0 (transparent) to 255 (opaque).
+				unsigned char alpha;
+			};
+
 			/// Defines the scrolling behavior of a Canvas.
 			struct Scroll {
 				/// The direction and rate that the Canvas will scroll along the x-axis.
@@ -27,56 +45,118 @@ namespace PixelMaestro {
 				/// The last time the Canvas scrolled along the y-axis.
 				unsigned long last_scroll_y = 0;
 
+				/// The distance scrolled but not yet applied along the x-axis, in 1/256ths of a Pixel.
+				unsigned char remainder_x = 0;
+				/// The distance scrolled but not yet applied along the y-axis, in 1/256ths of a Pixel.
+				unsigned char remainder_y = 0;
+
 				/// Whether to repeat the Pattern while scrolling over the grid.
 				bool repeat = false;
 
+				/// The distance to scroll along the x-axis each interval, in 1/256ths of a Pixel. Defaults to 256 (1 Pixel).
+				unsigned short step_x = 256;
+				/// The distance to scroll along the y-axis each interval, in 1/256ths of a Pixel. Defaults to 256 (1 Pixel).
+				unsigned short step_y = 256;
+
 				/**
 				 * Constructor. Sets the scroll rate and direction.
 				 * @param x Scrolling along the x-axis.
 				 * @param y Scrolling along the y-axis.
 				 * @param repeat If true, repeat the Canvas while scrolling.
+				 * @param step_x Distance to scroll along the x-axis each interval, in 1/256ths of a Pixel.
+				 * @param step_y Distance to scroll along the y-axis each interval, in 1/256ths of a Pixel.
 				 */
-				Scroll(signed short x, signed short y, bool repeat) {
+				Scroll(signed short x, signed short y, bool repeat, unsigned short step_x = 256, unsigned short step_y = 256) {
 					this->interval_x = x;
 					this->interval_y = y;
 					this->repeat = repeat;
+					this->step_x = step_x;
+					this->step_y = step_y;
 				}
 
 			};
 
+			/// The number of Pixels stored in each word of the pattern. This is also the width of each tile.
+			static const unsigned char WORD_BITS = sizeof(unsigned long) * 8;
+
+			/// The number of rows in each tile.
+			static const unsigned char TILE_HEIGHT = 8;
+
 			Canvas(Section* section);
+			void blend_pixel(unsigned int index, Colors::RGB* color);
 			void clear();
 			void draw_circle(unsigned short origin_x, unsigned short origin_y, unsigned short radius, bool fill);
+			void draw_ellipse(unsigned short origin_x, unsigned short origin_y, unsigned short radius_x, unsigned short radius_y, bool fill);
 			void draw_line(unsigned short origin_x, unsigned short origin_y, unsigned short target_x, unsigned short target_y);
 			void draw_point(unsigned short x, unsigned short y);
+			void draw_polygon(Point* points, unsigned short num_points, bool fill);
 			void draw_rect(unsigned short origin_x, unsigned short origin_y, unsigned short size_x, unsigned short size_y, bool fill);
 			void draw_text(unsigned short origin_x, unsigned short origin_y, Font* font, const char* text);
 			void draw_triangle(unsigned short point_a_x, unsigned short point_a_y, unsigned short point_b_x, unsigned short point_b_y, unsigned short point_c_x, unsigned short point_c_y, bool fill);
 			void erase(unsigned short x, unsigned short y);
-			bool* get_pattern();
+			void fill();
+			PixelColor* get_drawing_color();
+			Mode get_mode();
+			unsigned int get_num_drawn();
+			PixelColor* get_pattern_color(unsigned int index);
 			bool get_pattern_index(unsigned int index);
+			unsigned long get_pattern_span(unsigned int start);
 			Section* get_section();
+			Point* get_size();
+			unsigned long get_time_until_change(const unsigned long& current_time);
 			bool in_bounds(Point* point);
 			bool in_bounds(unsigned short x, unsigned short y);
 			void initialize_pattern();
 			void remove_scroll();
-			void set_scroll(signed short x, signed short y, bool repeat);
+			Scroll* get_scroll();
+			void set_drawing_color(Colors::RGB* color, unsigned char alpha = 255);
+			void set_mode(Mode mode);
+			void set_scroll(signed short x, signed short y, bool repeat, unsigned short step_x = 256, unsigned short step_y = 256);
 			void set_section(Section* section_);
 			void set_offset(signed short x, signed short y);
-			void update(const unsigned long& current_time);
+			void set_size(unsigned short x, unsigned short y);
+			bool update(const unsigned long& current_time);
 			void update_scroll(const unsigned long& current_time);
 			~Canvas();
 
 		private:
+			/// Whether the pattern or offset has changed since the last update.
+			bool changed_ = true;
+
+			/**
+				The color of each drawn Pixel (COLOR mode only).
+				Stored in tiles that match the tiles in tiles_, with WORD_BITS x TILE_HEIGHT colors per tile stored row by row. Color tiles are allocated along with their pattern tiles.
+			*/
+			PixelColor** color_tiles_ = nullptr;
+
+			/// The color used for drawing in COLOR mode.
+			PixelColor drawing_color_ = {{255, 255, 255}, 255};
+
+			/// How the Canvas displays its pattern.
+			Mode mode_ = Mode::MASK;
+
 			/// How far the Canvas is offset from the Pixel grid origin.
 			signed int offset_x_ = 0;
 			signed int offset_y_ = 0;
 
+			/// The number of tiles along the x-axis.
+			unsigned short num_tiles_x_ = 0;
+
+			/// The number of tiles along the y-axis.
+			unsigned short num_tiles_y_ = 0;
+
+			/// Whether the Canvas has its own size (true) or matches the size of the Section (false).
+			bool custom_size_ = false;
+
 			/**
 				The pattern to display.
-				Stored as an array of booleans where 'true' indicates a drawn Pixel.
+				The pattern is split into tiles of WORD_BITS x TILE_HEIGHT Pixels, stored row by row. Each tile is an array of TILE_HEIGHT words, one per row, where bit n of a word is column n of the tile and 1 indicates a drawn Pixel.
+				Tiles are only allocated once something is drawn on them, so a blank tile is a nullptr.
 			*/
-			bool* pattern_ = nullptr;
+			unsigned long** tiles_ = nullptr;
+
+			/// The size of the Canvas. This can be larger than the Section, in which case the Section shows part of the Canvas.
+			Point size_ = {0, 0};
 
 			/// The scrolling behavior of the Canvas.
 			Scroll* scroll_ = nullptr;
@@ -86,6 +166,18 @@ namespace PixelMaestro {
 			 * This is automatically set after using Section::set_canvas().
 			 */
 			Section* section_ = nullptr;
+
+			void delete_tiles();
+			void draw_span(signed long y, signed long start_x, signed long end_x);
+			void fill_row(unsigned short y, unsigned short x, unsigned short length, bool value);
+			unsigned long get_row_span(unsigned short y, unsigned short x, unsigned char count);
+			bool get_source(unsigned int index, unsigned short* x, unsigned short* y);
+			unsigned long get_stored_span(unsigned short x, unsigned short y);
+			unsigned long* get_tile(unsigned short tile_x, unsigned short tile_y, bool allocate);
+			void paint(unsigned short x, unsigned short y);
+			void plot(signed long x, signed long y);
+			void scroll_axis(signed short interval, unsigned short step, unsigned long* last_scroll, unsigned char* remainder, signed int* offset, signed long min_offset, unsigned long range, const unsigned long& current_time);
+			void set_point(unsigned short x, unsigned short y, bool value);
 	};
 }
 
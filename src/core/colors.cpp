@@ -5,7 +5,409 @@
 #include "../utility.h"
 #include "colors.h"
 
+#if defined(__SSE2__)
+	#include <emmintrin.h>
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#include <immintrin.h>
+	#define PIXELMAESTRO_AVX2
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define PIXELMAESTRO_NEON
+#endif
+
 namespace PixelMaestro {
+
+	/*
+		Span kernels.
+		Colors::RGB arrays are tightly packed, so a span of colors can be processed as a flat array of bytes.
+		Each kernel has a scalar version and (where supported) vectorized versions that produce identical results.
+		The fastest version supported by the CPU is chosen once at startup.
+	*/
+
+	static_assert(sizeof(Colors::RGB) == 3, "Colors::RGB must be tightly packed for span kernels to work.");
+
+	/// Blends each byte of start and end using an 8-bit weight: (start * (256 - weight) + end * weight) >> 8.
+	typedef void (*InterpolateKernel)(const unsigned char* start, const unsigned char* end, unsigned char* output, unsigned int num_bytes, unsigned short weight);
+
+	static void interpolate_scalar(const unsigned char* start, const unsigned char* end, unsigned char* output, unsigned int num_bytes, unsigned short weight) {
+		unsigned short inverse = 256 - weight;
+		for (unsigned int i = 0; i < num_bytes; i++) {
+			output[i] = ((start[i] * inverse) + (end[i] * weight)) >> 8;
+		}
+	}
+
+#if defined(__SSE2__)
+	static void interpolate_sse2(const unsigned char* start, const unsigned char* end, unsigned char* output, unsigned int num_bytes, unsigned short weight) {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i end_weight = _mm_set1_epi16(weight);
+		const __m128i start_weight = _mm_set1_epi16(256 - weight);
+
+		// Widen 16 bytes at a time to 16-bit lanes. The weighted sum never exceeds 255 * 256, so it fits.
+		unsigned int i = 0;
+		for (; i + 16 <= num_bytes; i += 16) {
+			__m128i a = _mm_loadu_si128((const __m128i*)(start + i));
+			__m128i b = _mm_loadu_si128((const __m128i*)(end + i));
+			__m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), start_weight), _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), end_weight));
+			__m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), start_weight), _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), end_weight));
+			_mm_storeu_si128((__m128i*)(output + i), _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8)));
+		}
+		interpolate_scalar(start + i, end + i, output + i, num_bytes - i, weight);
+	}
+#endif
+
+#if defined(PIXELMAESTRO_AVX2)
+	__attribute__((target("avx2")))
+	static void interpolate_avx2(const unsigned char* start, const unsigned char* end, unsigned char* output, unsigned int num_bytes, unsigned short weight) {
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i end_weight = _mm256_set1_epi16(weight);
+		const __m256i start_weight = _mm256_set1_epi16(256 - weight);
+
+		// Unpacking and packing both work within 128-bit lanes, so the byte order is preserved.
+		unsigned int i = 0;
+		for (; i + 32 <= num_bytes; i += 32) {
+			__m256i a = _mm256_loadu_si256((const __m256i*)(start + i));
+			__m256i b = _mm256_loadu_si256((const __m256i*)(end + i));
+			__m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(a, zero), start_weight), _mm256_mullo_epi16(_mm256_unpacklo_epi8(b, zero), end_weight));
+			__m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(a, zero), start_weight), _mm256_mullo_epi16(_mm256_unpackhi_epi8(b, zero), end_weight));
+			_mm256_storeu_si256((__m256i*)(output + i), _mm256_packus_epi16(_mm256_srli_epi16(lo, 8), _mm256_srli_epi16(hi, 8)));
+		}
+		interpolate_scalar(start + i, end + i, output + i, num_bytes - i, weight);
+	}
+#endif
+
+#if defined(PIXELMAESTRO_NEON)
+	static void interpolate_neon(const unsigned char* start, const unsigned char* end, unsigned char* output, unsigned int num_bytes, unsigned short weight) {
+		// 256 - weight doesn't fit in 8 bits, so multiply by (255 - weight) and add start back in.
+		const uint8x8_t end_weight = vdup_n_u8((unsigned char)weight);
+		const uint8x8_t start_weight = vdup_n_u8((unsigned char)(255 - weight));
+
+		unsigned int i = 0;
+		for (; i + 16 <= num_bytes; i += 16) {
+			uint8x16_t a = vld1q_u8(start + i);
+			uint8x16_t b = vld1q_u8(end + i);
+			uint16x8_t lo = vaddw_u8(vmlal_u8(vmull_u8(vget_low_u8(a), start_weight), vget_low_u8(b), end_weight), vget_low_u8(a));
+			uint16x8_t hi = vaddw_u8(vmlal_u8(vmull_u8(vget_high_u8(a), start_weight), vget_high_u8(b), end_weight), vget_high_u8(a));
+			vst1q_u8(output + i, vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)));
+		}
+		interpolate_scalar(start + i, end + i, output + i, num_bytes - i, weight);
+	}
+#endif
+
+	/**
+	 * Chooses the fastest interpolation kernel supported by the CPU.
+	 * @return Interpolation kernel.
+	 */
+	static InterpolateKernel select_interpolate_kernel() {
+#if defined(PIXELMAESTRO_AVX2)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2")) {
+			return interpolate_avx2;
+		}
+#endif
+#if defined(__SSE2__)
+		return interpolate_sse2;
+#elif defined(PIXELMAESTRO_NEON)
+		return interpolate_neon;
+#else
+		return interpolate_scalar;
+#endif
+	}
+
+	/// The interpolation kernel used by interpolate_span().
+	static InterpolateKernel interpolate_kernel = select_interpolate_kernel();
+
+	/**
+		Blend kernels.
+		These apply the per-channel MixModes (MULTIPLY, ADD, SCREEN, LIGHTEN, and DIFFERENCE) to each byte of base and overlay.
+		Any other mode copies the overlay.
+	*/
+	typedef void (*BlendKernel)(const unsigned char* base, const unsigned char* overlay, unsigned char* output, unsigned int num_bytes, Colors::MixMode mode);
+
+	/**
+		Fade kernels.
+		These calculate ((base * (255 - alpha)) + (overlay * alpha)) / 255 for each byte, rounded to the nearest integer.
+		Unlike the interpolation kernels, an alpha of 255 returns the overlay exactly.
+	*/
+	typedef void (*FadeKernel)(const unsigned char* base, const unsigned char* overlay, unsigned char* output, unsigned int num_bytes, unsigned char alpha);
+
+	/**
+	 * Divides a product of two bytes by 255, rounding to the nearest integer.
+	 * @param value Product to divide.
+	 * @return Quotient.
+	 */
+	static inline unsigned char divide_255(unsigned short value) {
+		value += 128;
+		return (value + (value >> 8)) >> 8;
+	}
+
+	static void blend_scalar(const unsigned char* base, const unsigned char* overlay, unsigned char* output, unsigned int num_bytes, Colors::MixMode mode) {
+		for (unsigned int i = 0; i < num_bytes; i++) {
+			switch (mode) {
+				case Colors::MixMode::MULTIPLY:
+					output[i] = divide_255((unsigned short)base[i] * overlay[i]);
+					break;
+				case Colors::MixMode::ADD:
+					output[i] = Colors::add8(base[i], overlay[i]);
+					break;
+				case Colors::MixMode::SCREEN:
+					output[i] = 255 - divide_255((unsigned short)(255 - base[i]) * (255 - overlay[i]));
+					break;
+				case Colors::MixMode::LIGHTEN:
+					output[i] = (base[i] > overlay[i]) ? base[i] : overlay[i];
+					break;
+				case Colors::MixMode::DIFFERENCE:
+					output[i] = (base[i] > overlay[i]) ? base[i] - overlay[i] : overlay[i] - base[i];
+					break;
+				default:
+					output[i] = overlay[i];
+					break;
+			}
+		}
+	}
+
+	static void fade_scalar(const unsigned char* base, const unsigned char* overlay, unsigned char* output, unsigned int num_bytes, unsigned char alpha) {
+		for (unsigned int i = 0; i < num_bytes; i++) {
+			output[i] = Colors::lerp8(base[i], overlay[i], alpha);
+		}
+	}
+
+	/**
+		Arithmetic kernels.
+		These apply the saturating color math functions (e.g. subtract8() and scale8()) to each byte.
+	*/
+	typedef void (*SubtractKernel)(const unsigned char* values_one, const unsigned char* values_two, unsigned char* output, unsigned int num_bytes);
+	typedef void (*ScaleKernel)(const unsigned char* values, unsigned char* output, unsigned int num_bytes, unsigned char scale);
+
+	static void subtract_scalar(const unsigned char* values_one, const unsigned char* values_two, unsigned char* output, unsigned int num_bytes) {
+		for (unsigned int i = 0; i < num_bytes; i++) {
+			output[i] = Colors::subtract8(values_one[i], values_two[i]);
+		}
+	}
+
+	static void scale_scalar(const unsigned char* values, unsigned char* output, unsigned int num_bytes, unsigned char scale) {
+		for (unsigned int i = 0; i < num_bytes; i++) {
+			output[i] = Colors::scale8(values[i], scale);
+		}
+	}
+
+#if defined(__SSE2__)
+	/**
+	 * Divides 16 unsigned 16-bit values by 255, rounding to the nearest integer, and packs the results into bytes.
+	 * @param lo First 8 values.
+	 * @param hi Last 8 values.
+	 * @return 16 quotients.
+	 */
+	static inline __m128i divide_255_sse2(__m128i lo, __m128i hi) {
+		const __m128i half = _mm_set1_epi16(128);
+		lo = _mm_add_epi16(lo, half);
+		hi = _mm_add_epi16(hi, half);
+		lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+		hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+		return _mm_packus_epi16(lo, hi);
+	}
+
+	/**
+	 * Multiplies each pair of bytes and divides by 255, rounding to the nearest integer.
+	 * @param a First 16 bytes.
+	 * @param b Second 16 bytes.
+	 * @return 16 products.
+	 */
+	static inline __m128i multiply_sse2(__m128i a, __m128i b) {
+		const __m128i zero = _mm_setzero_si128();
+		__m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+		__m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+		return divide_255_sse2(lo, hi);
+	}
+
+	static void blend_sse2(const unsigned char* base, const unsigned char* overlay, unsigned char* output, unsigned int num_bytes, Colors::MixMode mode) {
+		const __m128i ones = _mm_set1_epi8((char)0xFF);
+		unsigned int i = 0;
+		for (; i + 16 <= num_bytes; i += 16) {
+			__m128i a = _mm_loadu_si128((const __m128i*)(base + i));
+			__m128i b = _mm_loadu_si128((const __m128i*)(overlay + i));
+			__m128i result;
+			switch (mode) {
+				case Colors::MixMode::MULTIPLY:
+					result = multiply_sse2(a, b);
+					break;
+				case Colors::MixMode::ADD:
+					result = _mm_adds_epu8(a, b);
+					break;
+				case Colors::MixMode::SCREEN:
+					result = _mm_xor_si128(multiply_sse2(_mm_xor_si128(a, ones), _mm_xor_si128(b, ones)), ones);
+					break;
+				case Colors::MixMode::LIGHTEN:
+					result = _mm_max_epu8(a, b);
+					break;
+				case Colors::MixMode::DIFFERENCE:
+					result = _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+					break;
+				default:
+					result = b;
+					break;
+			}
+			_mm_storeu_si128((__m128i*)(output + i), result);
+		}
+		blend_scalar(base + i, overlay + i, output + i, num_bytes - i, mode);
+	}
+
+	static void fade_sse2(const unsigned char* base, const unsigned char* overlay, unsigned char* output, unsigned int num_bytes, unsigned char alpha) {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i overlay_weight = _mm_set1_epi16(alpha);
+		const __m128i base_weight = _mm_set1_epi16(255 - alpha);
+
+		// The weighted sum never exceeds 255 * 255, so it fits in 16 bits.
+		unsigned int i = 0;
+		for (; i + 16 <= num_bytes; i += 16) {
+			__m128i a = _mm_loadu_si128((const __m128i*)(base + i));
+			__m128i b = _mm_loadu_si128((const __m128i*)(overlay + i));
+			__m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), base_weight), _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), overlay_weight));
+			__m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), base_weight), _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), overlay_weight));
+			_mm_storeu_si128((__m128i*)(output + i), divide_255_sse2(lo, hi));
+		}
+		fade_scalar(base + i, overlay + i, output + i, num_bytes - i, alpha);
+	}
+
+	static void subtract_sse2(const unsigned char* values_one, const unsigned char* values_two, unsigned char* output, unsigned int num_bytes) {
+		unsigned int i = 0;
+		for (; i + 16 <= num_bytes; i += 16) {
+			__m128i a = _mm_loadu_si128((const __m128i*)(values_one + i));
+			__m128i b = _mm_loadu_si128((const __m128i*)(values_two + i));
+			_mm_storeu_si128((__m128i*)(output + i), _mm_subs_epu8(a, b));
+		}
+		subtract_scalar(values_one + i, values_two + i, output + i, num_bytes - i);
+	}
+
+	static void scale_sse2(const unsigned char* values, unsigned char* output, unsigned int num_bytes, unsigned char scale) {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i factor = _mm_set1_epi16(scale + 1);
+
+		// 255 * 256 fits in 16 bits, so the products can be shifted directly.
+		unsigned int i = 0;
+		for (; i + 16 <= num_bytes; i += 16) {
+			__m128i a = _mm_loadu_si128((const __m128i*)(values + i));
+			__m128i lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), factor), 8);
+			__m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), factor), 8);
+			_mm_storeu_si128((__m128i*)(output + i), _mm_packus_epi16(lo, hi));
+		}
+		scale_scalar(values + i, output + i, num_bytes - i, scale);
+	}
+#endif
+
+#if defined(PIXELMAESTRO_NEON)
+	/**
+	 * Divides 16 unsigned 16-bit values by 255, rounding to the nearest integer, and narrows the results to bytes.
+	 * @param lo First 8 values.
+	 * @param hi Last 8 values.
+	 * @return 16 quotients.
+	 */
+	static inline uint8x16_t divide_255_neon(uint16x8_t lo, uint16x8_t hi) {
+		const uint16x8_t half = vdupq_n_u16(128);
+		lo = vaddq_u16(lo, half);
+		hi = vaddq_u16(hi, half);
+		return vcombine_u8(vshrn_n_u16(vsraq_n_u16(lo, lo, 8), 8), vshrn_n_u16(vsraq_n_u16(hi, hi, 8), 8));
+	}
+
+	/**
+	 * Multiplies each pair of bytes and divides by 255, rounding to the nearest integer.
+	 * @param a First 16 bytes.
+	 * @param b Second 16 bytes.
+	 * @return 16 products.
+	 */
+	static inline uint8x16_t multiply_neon(uint8x16_t a, uint8x16_t b) {
+		return divide_255_neon(vmull_u8(vget_low_u8(a), vget_low_u8(b)), vmull_u8(vget_high_u8(a), vget_high_u8(b)));
+	}
+
+	static void blend_neon(const unsigned char* base, const unsigned char* overlay, unsigned char* output, unsigned int num_bytes, Colors::MixMode mode) {
+		unsigned int i = 0;
+		for (; i + 16 <= num_bytes; i += 16) {
+			uint8x16_t a = vld1q_u8(base + i);
+			uint8x16_t b = vld1q_u8(overlay + i);
+			uint8x16_t result;
+			switch (mode) {
+				case Colors::MixMode::MULTIPLY:
+					result = multiply_neon(a, b);
+					break;
+				case Colors::MixMode::ADD:
+					result = vqaddq_u8(a, b);
+					break;
+				case Colors::MixMode::SCREEN:
+					result = vmvnq_u8(multiply_neon(vmvnq_u8(a), vmvnq_u8(b)));
+					break;
+				case Colors::MixMode::LIGHTEN:
+					result = vmaxq_u8(a, b);
+					break;
+				case Colors::MixMode::DIFFERENCE:
+					result = vabdq_u8(a, b);
+					break;
+				default:
+					result = b;
+					break;
+			}
+			vst1q_u8(output + i, result);
+		}
+		blend_scalar(base + i, overlay + i, output + i, num_bytes - i, mode);
+	}
+
+	static void fade_neon(const unsigned char* base, const unsigned char* overlay, unsigned char* output, unsigned int num_bytes, unsigned char alpha) {
+		// Both weights fit in 8 bits, so widen while multiplying.
+		const uint8x8_t overlay_weight = vdup_n_u8(alpha);
+		const uint8x8_t base_weight = vdup_n_u8(255 - alpha);
+
+		unsigned int i = 0;
+		for (; i + 16 <= num_bytes; i += 16) {
+			uint8x16_t a = vld1q_u8(base + i);
+			uint8x16_t b = vld1q_u8(overlay + i);
+			uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(a), base_weight), vget_low_u8(b), overlay_weight);
+			uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(a), base_weight), vget_high_u8(b), overlay_weight);
+			vst1q_u8(output + i, divide_255_neon(lo, hi));
+		}
+		fade_scalar(base + i, overlay + i, output + i, num_bytes - i, alpha);
+	}
+
+	static void subtract_neon(const unsigned char* values_one, const unsigned char* values_two, unsigned char* output, unsigned int num_bytes) {
+		unsigned int i = 0;
+		for (; i + 16 <= num_bytes; i += 16) {
+			vst1q_u8(output + i, vqsubq_u8(vld1q_u8(values_one + i), vld1q_u8(values_two + i)));
+		}
+		subtract_scalar(values_one + i, values_two + i, output + i, num_bytes - i);
+	}
+
+	static void scale_neon(const unsigned char* values, unsigned char* output, unsigned int num_bytes, unsigned char scale) {
+		// scale + 1 doesn't fit in 8 bits, so multiply by scale and add the value back in.
+		const uint8x8_t factor = vdup_n_u8(scale);
+
+		unsigned int i = 0;
+		for (; i + 16 <= num_bytes; i += 16) {
+			uint8x16_t a = vld1q_u8(values + i);
+			uint16x8_t lo = vaddw_u8(vmull_u8(vget_low_u8(a), factor), vget_low_u8(a));
+			uint16x8_t hi = vaddw_u8(vmull_u8(vget_high_u8(a), factor), vget_high_u8(a));
+			vst1q_u8(output + i, vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)));
+		}
+		scale_scalar(values + i, output + i, num_bytes - i, scale);
+	}
+#endif
+
+	/// The kernels used by mix_span() and the color math functions. SSE2 and NEON are part of the baseline on the platforms that have them, so no runtime check is needed.
+#if defined(__SSE2__)
+	static BlendKernel blend_kernel = blend_sse2;
+	static FadeKernel fade_kernel = fade_sse2;
+	static ScaleKernel scale_kernel = scale_sse2;
+	static SubtractKernel subtract_kernel = subtract_sse2;
+#elif defined(PIXELMAESTRO_NEON)
+	static BlendKernel blend_kernel = blend_neon;
+	static FadeKernel fade_kernel = fade_neon;
+	static ScaleKernel scale_kernel = scale_neon;
+	static SubtractKernel subtract_kernel = subtract_neon;
+#else
+	static BlendKernel blend_kernel = blend_scalar;
+	static FadeKernel fade_kernel = fade_scalar;
+	static ScaleKernel scale_kernel = scale_scalar;
+	static SubtractKernel subtract_kernel = subtract_scalar;
+#endif
+
 	// Simple color set
 	Colors::RGB Colors::RED 	= {255, 0, 0};
 	Colors::RGB Colors::GREEN 	= {0, 255, 0};
@@ -50,6 +452,30 @@ namespace PixelMaestro {
 		Colors::VIOLET
 	};
 
+	/**
+		Adds two arrays of colors in a single pass. Equivalent to calling add() on each pair of colors.
+		Uses SIMD instructions where available.
+
+		@param colors_one The first set of colors.
+		@param colors_two The second set of colors.
+		@param output Array to store the sums in. Can be the same as either input.
+		@param num_colors The number of colors in each array.
+	*/
+	void Colors::add_span(const RGB* colors_one, const RGB* colors_two, RGB* output, unsigned int num_colors) {
+		blend_kernel(&colors_one->r, &colors_two->r, &output->r, num_colors * sizeof(RGB), MixMode::ADD);
+	}
+
+	/**
+	 * Converts the time spent fading into a fixed-point progress value for use with interpolate().
+	 * This is the only division needed per fade update, regardless of the number of Pixels being faded.
+	 * @param elapsed The amount of time (in milliseconds) since the fade started.
+	 * @param duration The total length of the fade (in milliseconds). Must be greater than elapsed.
+	 * @return Fade progress from 0 to 65535.
+	 */
+	unsigned long Colors::get_fade_progress(unsigned long elapsed, unsigned short duration) {
+		return (elapsed << 16) / duration;
+	}
+
 	/**
 	 * Creates a random color.
 	 * @return Random color.
@@ -143,48 +569,129 @@ namespace PixelMaestro {
 	}
 
 	/**
-		Mixes two colors.
+		Blends two arrays of colors in a single pass. Equivalent to calling interpolate() on each pair of colors.
+		Uses SIMD instructions where available.
 
-		@param color_one The first color to mix.
-		@param color_two The second color to mix.
-		@param mode The type of mixing to perform.
-		@param alpha Color two alpha factor (0 - 255).
-		@return The mixed color.
+		@param start The colors at the start of the transition.
+		@param end The colors at the end of the transition.
+		@param output Array to store the blended colors in. Can be the same as start or end.
+		@param num_colors The number of colors in each array.
+		@param progress How far along the transition is, from 0 (start) to 65535 (just short of end).
 	*/
-	Colors::RGB Colors::mix_colors(RGB* color_one, RGB* color_two, MixMode mode, unsigned char alpha) {
-		RGB mixed_color;
+	void Colors::interpolate_span(RGB* start, RGB* end, RGB* output, unsigned int num_colors, unsigned long progress) {
+		interpolate_kernel(&start->r, &end->r, &output->r, num_colors * sizeof(RGB), progress >> 8);
+	}
+
+	/**
+		Blends two arrays of colors in a single pass. Equivalent to calling lerp() on each pair of colors.
+		Uses SIMD instructions where available.
+
+		@param start The colors at an alpha of 0.
+		@param end The colors at an alpha of 255.
+		@param output Array to store the blended colors in. Can be the same as start or end.
+		@param num_colors The number of colors in each array.
+		@param alpha How far to move towards the end colors (0 - 255).
+	*/
+	void Colors::lerp_span(const RGB* start, const RGB* end, RGB* output, unsigned int num_colors, unsigned char alpha) {
+		fade_kernel(&start->r, &end->r, &output->r, num_colors * sizeof(RGB), alpha);
+	}
+
+	/**
+		Mixes two arrays of colors in a single pass using integer math.
+		Each output color is the overlay color blended onto the base color using the mix mode. The result is then faded in over the base color using alpha, so alpha acts as the overlay's opacity in every mode.
+		Results are rounded to the nearest integer, so an alpha of 0 returns the base color and 255 returns the fully blended color.
+		Uses SIMD instructions where available.
+
+		@param base The colors underneath.
+		@param overlay The colors on top.
+		@param output Array to store the mixed colors in. Can be the same as base or overlay.
+		@param num_colors The number of colors in each array.
+		@param mode The type of mixing to perform. NONE returns the base colors.
+		@param alpha Opacity of the overlay, from 0 (transparent) to 255 (opaque).
+	*/
+	void Colors::mix_span(const RGB* base, const RGB* overlay, RGB* output, unsigned int num_colors, MixMode mode, unsigned char alpha) {
+		if (mode == MixMode::NONE || alpha == 0) {
+			if (output != base) {
+				for (unsigned int i = 0; i < num_colors; i++) {
+					output[i] = base[i];
+				}
+			}
+			return;
+		}
 
 		switch (mode) {
 			case MixMode::ALPHA:
-			{
-				float alpha_pct = alpha / (float)255;
-				mixed_color.r = (alpha_pct * color_two->r) + ((1 - alpha_pct) * color_one->r);
-				mixed_color.g = (alpha_pct * color_two->g) + ((1 - alpha_pct) * color_one->g);
-				mixed_color.b = (alpha_pct * color_two->b) + ((1 - alpha_pct) * color_one->b);
+				fade_kernel(&base->r, &overlay->r, &output->r, num_colors * sizeof(RGB), alpha);
 				break;
-			}
-			case MixMode::MULTIPLY:
-			{
-				mixed_color.r = color_one->r * (float)(color_two->r / (float)255);
-				mixed_color.g = color_one->g * (float)(color_two->g / (float)255);
-				mixed_color.b = color_one->b * (float)(color_two->b / (float)255);
-				break;
-			}
 			case MixMode::OVERLAY:
-			{
-				if (*color_two == Colors::BLACK) {
-					mixed_color = *color_one;
-				}
-				else {
-					mixed_color = *color_two;
+				// Black is transparent, so this works on whole colors instead of individual channels.
+				for (unsigned int i = 0; i < num_colors; i++) {
+					if (overlay[i] != Colors::BLACK) {
+						fade_scalar(&base[i].r, &overlay[i].r, &output[i].r, sizeof(RGB), alpha);
+					}
+					else {
+						output[i] = base[i];
+					}
 				}
 				break;
-			}
-			default:	// Return color_one
-				mixed_color = *color_one;
+			default:
+				if (alpha == 255) {
+					blend_kernel(&base->r, &overlay->r, &output->r, num_colors * sizeof(RGB), mode);
+					break;
+				}
+
+				// The output may be the same array as the base, so blend into a small buffer before fading it in.
+				{
+					const unsigned int chunk_size = 32;
+					RGB blended[chunk_size];
+					for (unsigned int start = 0; start < num_colors; start += chunk_size) {
+						unsigned int count = (num_colors - start < chunk_size) ? num_colors - start : chunk_size;
+						blend_kernel(&base[start].r, &overlay[start].r, &blended->r, count * sizeof(RGB), mode);
+						fade_kernel(&base[start].r, &blended->r, &output[start].r, count * sizeof(RGB), alpha);
+					}
+				}
 				break;
-		};
+		}
+	}
+
+	/**
+		Mixes two colors. This is the same as calling mix_span() with a single color.
 
+		@param color_one The first color to mix.
+		@param color_two The second color to mix.
+		@param mode The type of mixing to perform.
+		@param alpha Opacity of color two (0 - 255).
+		@return The mixed color.
+	*/
+	Colors::RGB Colors::mix_colors(const RGB* color_one, const RGB* color_two, MixMode mode, unsigned char alpha) {
+		RGB mixed_color;
+		mix_span(color_one, color_two, &mixed_color, 1, mode, alpha);
 		return mixed_color;
 	}
+
+	/**
+		Scales an array of colors in a single pass. Equivalent to calling scale() on each color.
+		Uses SIMD instructions where available.
+
+		@param colors The colors to scale.
+		@param output Array to store the scaled colors in. Can be the same as colors.
+		@param num_colors The number of colors in the array.
+		@param scale The fraction to scale by, where 255 leaves the colors unchanged and 0 returns black.
+	*/
+	void Colors::scale_span(const RGB* colors, RGB* output, unsigned int num_colors, unsigned char scale) {
+		scale_kernel(&colors->r, &output->r, num_colors * sizeof(RGB), scale);
+	}
+
+	/**
+		Subtracts one array of colors from another in a single pass. Equivalent to calling subtract() on each pair of colors.
+		Uses SIMD instructions where available.
+
+		@param colors_one The colors to subtract from.
+		@param colors_two The colors to subtract.
+		@param output Array to store the differences in. Can be the same as either input.
+		@param num_colors The number of colors in each array.
+	*/
+	void Colors::subtract_span(const RGB* colors_one, const RGB* colors_two, RGB* output, unsigned int num_colors) {
+		subtract_kernel(&colors_one->r, &colors_two->r, &output->r, num_colors * sizeof(RGB));
+	}
 }
@@ -27,45 +27,59 @@ namespace PixelMaestro {
 					b = color_two.b;
 				}
 
-				bool operator==(RGB color_two) {
+				bool operator==(RGB color_two) const {
 					return r == color_two.r && g == color_two.g && b == color_two.b;
 				}
 
-				bool operator!=(RGB color_two) {
+				bool operator!=(RGB color_two) const {
 					return !operator==(color_two);
 				}
 
-				RGB operator+(RGB color_two) {
-					return {
-						(unsigned char)((r + color_two.r) % 255),
-						(unsigned char)((g + color_two.g) % 255),
-						(unsigned char)((b + color_two.b) % 255)
-					};
+				/// Adds two colors, stopping at 255. See Colors::add().
+				RGB operator+(RGB color_two) const {
+					return Colors::add(this, &color_two);
 				}
 
-				RGB operator-(RGB color_two) {
-					return {
-						(unsigned char)((r - color_two.r) % 255),
-						(unsigned char)((g - color_two.g) % 255),
-						(unsigned char)((b - color_two.b) % 255)
-					};
+				/// Subtracts two colors, stopping at 0. See Colors::subtract().
+				RGB operator-(RGB color_two) const {
+					return Colors::subtract(this, &color_two);
 				}
 
-				RGB operator*(float multiplier) {
+				/// Multiplies each channel, stopping at 0 and 255. Uses floating point math; see Colors::scale() for an integer alternative.
+				RGB operator*(float multiplier) const {
 					return {
-						(unsigned char)(r * multiplier),
-						(unsigned char)(g * multiplier),
-						(unsigned char)(b * multiplier)
+						clamp_channel(r * multiplier),
+						clamp_channel(g * multiplier),
+						clamp_channel(b * multiplier)
 					};
 				}
 
-				RGB operator/(float divisor) {
+				/// Divides each channel, stopping at 0 and 255. Uses floating point math; see Colors::scale() for an integer alternative.
+				RGB operator/(float divisor) const {
 					return {
-						(unsigned char)(r / divisor),
-						(unsigned char)(g / divisor),
-						(unsigned char)(b / divisor)
+						clamp_channel(r / divisor),
+						clamp_channel(g / divisor),
+						clamp_channel(b / divisor)
 					};
 				}
+
+				private:
+					static unsigned char clamp_channel(float value) {
+						if (value <= 0) {
+							return 0;
+						}
+						if (value >= 255) {
+							return 255;
+						}
+						return (unsigned char)value;
+					}
+			};
+
+			/// The order that color channels are written in when exporting a frame (e.g. WS2812 LEDs expect GRB).
+			enum class ColorOrder : unsigned char {
+				RGB,
+				GRB,
+				BRG
 			};
 
 			/// Determines the blending algorithm used when mixing two colors.
@@ -80,7 +94,19 @@ namespace PixelMaestro {
 				MULTIPLY,
 
 				/// Draws lit Pixels, but treats black Pixels as transparent.
-				OVERLAY
+				OVERLAY,
+
+				/// Adds the overlay color to the base color, stopping at white.
+				ADD,
+
+				/// Inverts both colors, multiplies them, then inverts the result. Brightens the base color.
+				SCREEN,
+
+				/// Uses the brighter of the two colors for each channel.
+				LIGHTEN,
+
+				/// Uses the difference between the two colors for each channel.
+				DIFFERENCE
 			};
 
 			// Basic color set.
@@ -106,11 +132,155 @@ namespace PixelMaestro {
 			static RGB COLORWHEEL[];
 			static RGB RAINBOW[];
 
+			/**
+				Returns the color that lies part of the way between two colors.
+				Uses fixed-point math, so no floating point operations are needed.
+				The top 8 bits of progress are used as the blend weight. This matches interpolate_span() exactly.
+
+				@param start The color at the start of the transition.
+				@param end The color at the end of the transition.
+				@param progress How far along the transition is, from 0 (start) to 65535 (just short of end).
+				@return The intermediate color.
+			*/
+			static inline RGB interpolate(RGB* start, RGB* end, unsigned long progress) {
+				unsigned short weight = progress >> 8;
+				unsigned short inverse = 256 - weight;
+				return {
+					(unsigned char)(((start->r * inverse) + (end->r * weight)) >> 8),
+					(unsigned char)(((start->g * inverse) + (end->g * weight)) >> 8),
+					(unsigned char)(((start->b * inverse) + (end->b * weight)) >> 8)
+				};
+			}
+
+			/*
+				Color math.
+				These work per channel using integer math, and saturate instead of wrapping around.
+				Each has an array form (e.g. add_span()) that uses SIMD instructions where available and produces identical results.
+				To blend colors using a MixMode, see mix_colors() and mix_span().
+			*/
+
+			/**
+				Adds two colors. Channels stop at 255.
+
+				@param color_one The first color.
+				@param color_two The second color.
+				@return The sum of both colors.
+			*/
+			static inline RGB add(const RGB* color_one, const RGB* color_two) {
+				return {
+					add8(color_one->r, color_two->r),
+					add8(color_one->g, color_two->g),
+					add8(color_one->b, color_two->b)
+				};
+			}
+
+			/**
+				Adds two channel values, stopping at 255.
+
+				@param value_one The first value.
+				@param value_two The second value.
+				@return The sum of both values.
+			*/
+			static inline unsigned char add8(unsigned char value_one, unsigned char value_two) {
+				unsigned short sum = value_one + value_two;
+				return (sum > 255) ? 255 : sum;
+			}
+
+			/**
+				Returns the color part of the way between two colors.
+				Unlike interpolate(), the result is rounded to the nearest integer and an alpha of 255 returns the end color exactly.
+
+				@param start The color at an alpha of 0.
+				@param end The color at an alpha of 255.
+				@param alpha How far to move towards the end color (0 - 255).
+				@return The intermediate color.
+			*/
+			static inline RGB lerp(const RGB* start, const RGB* end, unsigned char alpha) {
+				return {
+					lerp8(start->r, end->r, alpha),
+					lerp8(start->g, end->g, alpha),
+					lerp8(start->b, end->b, alpha)
+				};
+			}
+
+			/**
+				Returns the channel value part of the way between two values, rounded to the nearest integer.
+				This calculates ((start * (255 - alpha)) + (end * alpha)) / 255 without dividing.
+
+				@param start The value at an alpha of 0.
+				@param end The value at an alpha of 255.
+				@param alpha How far to move towards the end value (0 - 255).
+				@return The intermediate value.
+			*/
+			static inline unsigned char lerp8(unsigned char start, unsigned char end, unsigned char alpha) {
+				unsigned short value = ((unsigned short)start * (255 - alpha)) + ((unsigned short)end * alpha) + 128;
+				return (value + (value >> 8)) >> 8;
+			}
+
+			/**
+				Scales a color by a fraction of 256.
+
+				@param color The color to scale.
+				@param scale The fraction to scale by, where 255 leaves the color unchanged and 0 returns black.
+				@return The scaled color.
+			*/
+			static inline RGB scale(const RGB* color, unsigned char scale) {
+				return {
+					scale8(color->r, scale),
+					scale8(color->g, scale),
+					scale8(color->b, scale)
+				};
+			}
+
+			/**
+				Scales a channel value by a fraction of 256. This is the same scaling that the Maestro uses for brightness.
+
+				@param value The value to scale.
+				@param scale The fraction to scale by, where 255 leaves the value unchanged and 0 returns 0.
+				@return The scaled value.
+			*/
+			static inline unsigned char scale8(unsigned char value, unsigned char scale) {
+				return ((unsigned short)value * (scale + 1)) >> 8;
+			}
+
+			/**
+				Subtracts one color from another. Channels stop at 0.
+
+				@param color_one The color to subtract from.
+				@param color_two The color to subtract.
+				@return The difference between the colors.
+			*/
+			static inline RGB subtract(const RGB* color_one, const RGB* color_two) {
+				return {
+					subtract8(color_one->r, color_two->r),
+					subtract8(color_one->g, color_two->g),
+					subtract8(color_one->b, color_two->b)
+				};
+			}
+
+			/**
+				Subtracts one channel value from another, stopping at 0.
+
+				@param value_one The value to subtract from.
+				@param value_two The value to subtract.
+				@return The difference between the values.
+			*/
+			static inline unsigned char subtract8(unsigned char value_one, unsigned char value_two) {
+				return (value_one > value_two) ? value_one - value_two : 0;
+			}
+
+			static void add_span(const RGB* colors_one, const RGB* colors_two, RGB* output, unsigned int num_colors);
+			static unsigned long get_fade_progress(unsigned long elapsed, unsigned short duration);
 			static RGB generate_random_color();
 			static void generate_random_color_array(RGB new_array[], RGB* base_color, unsigned int num_colors, float range = 1.0);
 			static void generate_scaling_color_array(RGB new_array[], RGB* base_color, RGB* target_color, unsigned int num_colors, bool reverse = false);
 			static void generate_scaling_color_array(RGB new_array[], RGB* base_color, unsigned int num_colors, unsigned char threshold, bool reverse = false);
-			static RGB mix_colors(RGB* color_one, RGB* color_two, MixMode mode, unsigned char alpha = 0);
+			static void interpolate_span(RGB* start, RGB* end, RGB* output, unsigned int num_colors, unsigned long progress);
+			static void lerp_span(const RGB* start, const RGB* end, RGB* output, unsigned int num_colors, unsigned char alpha);
+			static RGB mix_colors(const RGB* color_one, const RGB* color_two, MixMode mode, unsigned char alpha = 255);
+			static void mix_span(const RGB* base, const RGB* overlay, RGB* output, unsigned int num_colors, MixMode mode, unsigned char alpha);
+			static void scale_span(const RGB* colors, RGB* output, unsigned int num_colors, unsigned char scale);
+			static void subtract_span(const RGB* colors_one, const RGB* colors_two, RGB* output, unsigned int num_colors);
 	};
 }
 
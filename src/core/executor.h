@@ -0,0 +1,32 @@
+/*
+	Executor.h - Interface for running batches of tasks, optionally in parallel.
+*/
+
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+namespace PixelMaestro {
+	/**
+		Runs a batch of independent tasks and waits for all of them to finish.
+		The Maestro uses an Executor to update Sections in parallel. Implementations decide how (and whether) to distribute tasks across threads.
+	*/
+	class Executor {
+		public:
+			/// A single task. The index identifies the task within the batch, and the context is passed through from run().
+			typedef void (*Task)(unsigned int index, void* context);
+
+			virtual ~Executor() { }
+
+			/**
+				Runs the task once for each index from 0 to num_tasks - 1, and returns once every task has finished.
+				Tasks in the same batch may run in any order and at the same time.
+
+				@param task The task to run.
+				@param context Passed to each task as-is.
+				@param num_tasks Number of times to run the task.
+			*/
+			virtual void run(Task task, void* context, unsigned int num_tasks) = 0;
+	};
+}
+
+#endif // EXECUTOR_H
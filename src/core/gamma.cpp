@@ -0,0 +1,43 @@
+/*
+ * Gamma - Lookup tables for correcting LED output.
+ */
+
+#include "gamma.h"
+
+namespace PixelMaestro {
+
+	static constexpr unsigned short power_2_2(unsigned char value) {
+		return Gamma::power16(value, 2.2);
+	}
+
+	static constexpr unsigned short power_2_8(unsigned char value) {
+		return Gamma::power16(value, 2.8);
+	}
+
+	static constexpr unsigned short cie_lightness(unsigned char value) {
+		return Gamma::cie16(value);
+	}
+
+	// The tables must be calculated by the compiler, not at startup.
+	static_assert(Gamma::power16(128, 2.2) == 14330, "Gamma curves must be constant expressions.");
+
+	const unsigned short Gamma::POWER_2_2[256] = { PIXELMAESTRO_GAMMA_TABLE(power_2_2) };
+	const unsigned short Gamma::POWER_2_8[256] = { PIXELMAESTRO_GAMMA_TABLE(power_2_8) };
+	const unsigned short Gamma::CIE_LIGHTNESS[256] = { PIXELMAESTRO_GAMMA_TABLE(cie_lightness) };
+
+	/**
+		Combines a gamma curve and a brightness level into a single table of output levels.
+		The curve is applied first, then the result is scaled by the brightness the same way as Colors::scale8(), keeping the fraction.
+		Without a curve, the high byte of each level is exactly Colors::scale8(value, brightness).
+
+		@param levels Table of 256 entries to store the output levels in.
+		@param curve Gamma table to apply, or nullptr to leave values uncorrected.
+		@param brightness Brightness level from 0 (off) to 255 (full).
+	*/
+	void Gamma::build_levels(unsigned short* levels, const unsigned short* curve, unsigned char brightness) {
+		for (unsigned short value = 0; value < 256; value++) {
+			unsigned short corrected = (curve != nullptr) ? curve[value] : (unsigned short)(value << 8);
+			levels[value] = ((unsigned long)corrected * (brightness + 1)) >> 8;
+		}
+	}
+}
@@ -0,0 +1,107 @@
+/*
+ * Gamma - Lookup tables for correcting LED output.
+ */
+
+#ifndef GAMMA_H
+#define GAMMA_H
+
+/*
+	Expands to a comma-separated list of function(0) through function(255).
+	Use this with a constexpr function to build a gamma table at compile time, e.g.:
+	constexpr unsigned short gamma_2_8(unsigned char value) { return Gamma::power16(value, 2.8); }
+	const unsigned short GAMMA_2_8[256] = { PIXELMAESTRO_GAMMA_TABLE(gamma_2_8) };
+*/
+#define PIXELMAESTRO_GAMMA_4(function, start) function(start), function(start + 1), function(start + 2), function(start + 3)
+#define PIXELMAESTRO_GAMMA_16(function, start) PIXELMAESTRO_GAMMA_4(function, start), PIXELMAESTRO_GAMMA_4(function, start + 4), PIXELMAESTRO_GAMMA_4(function, start + 8), PIXELMAESTRO_GAMMA_4(function, start + 12)
+#define PIXELMAESTRO_GAMMA_64(function, start) PIXELMAESTRO_GAMMA_16(function, start), PIXELMAESTRO_GAMMA_16(function, start + 16), PIXELMAESTRO_GAMMA_16(function, start + 32), PIXELMAESTRO_GAMMA_16(function, start + 48)
+#define PIXELMAESTRO_GAMMA_TABLE(function) PIXELMAESTRO_GAMMA_64(function, 0), PIXELMAESTRO_GAMMA_64(function, 64), PIXELMAESTRO_GAMMA_64(function, 128), PIXELMAESTRO_GAMMA_64(function, 192)
+
+namespace PixelMaestro {
+	/**
+		Gamma tables map each channel value (0 - 255) to the level sent to the LEDs.
+		LEDs respond linearly to their input, but eyes don't, so without correction fades look like they jump at low levels and stall at high levels.
+		The constexpr functions calculate curves at compile time, so building a table doesn't need any floating point math at runtime.
+
+		Levels are stored in 8.8 fixed point: the high byte is the 8-bit output and the low byte is the fraction in between.
+		The fraction keeps dark values from collapsing to 0 and can be recovered by dithering (see Maestro::set_dithering()).
+	*/
+	class Gamma {
+		public:
+			/// The highest level, equal to an 8-bit output of 255.
+			static const unsigned short MAX_LEVEL = 255 << 8;
+
+			/// Power curve with an exponent of 2.2.
+			static const unsigned short POWER_2_2[256];
+
+			/// Power curve with an exponent of 2.8.
+			static const unsigned short POWER_2_8[256];
+
+			/// The CIE 1976 lightness (L*) curve.
+			static const unsigned short CIE_LIGHTNESS[256];
+
+			/**
+				Returns the level of a channel value after applying the CIE 1976 lightness (L*) curve.
+
+				@param value Channel value.
+				@return Corrected level (0 - MAX_LEVEL).
+			*/
+			static constexpr unsigned short cie16(unsigned char value) {
+				return (unsigned short)(cie_luminance(value * 100.0 / 255) * MAX_LEVEL + 0.5);
+			}
+
+			/**
+				Returns the level of a channel value after applying a power curve, rounded to the nearest step.
+
+				@param value Channel value.
+				@param exponent The curve's exponent. Higher values darken the low end more.
+				@return Corrected level (0 - MAX_LEVEL).
+			*/
+			static constexpr unsigned short power16(unsigned char value, double exponent) {
+				return (unsigned short)(power(value / 255.0, exponent) * MAX_LEVEL + 0.5);
+			}
+
+			static void build_levels(unsigned short* levels, const unsigned short* curve, unsigned char brightness);
+
+		private:
+			/*
+				constexpr functions in C++11 are limited to a single return statement, so these use recursion instead of loops.
+				x^exponent is calculated as e^(exponent * ln(x)).
+			*/
+
+			static constexpr double cie_luminance(double lightness) {
+				return (lightness <= 8) ? lightness / 903.3 : cube((lightness + 16) / 116);
+			}
+
+			static constexpr double cube(double value) {
+				return value * value * value;
+			}
+
+			/// Returns e^value. Halves the value until the Taylor series converges quickly, then squares the result back up.
+			static constexpr double exponential(double value) {
+				return (value < -0.5 || value > 0.5) ? square(exponential(value / 2)) : exponential_series(value, 1, 1);
+			}
+
+			static constexpr double exponential_series(double value, double term, unsigned char n) {
+				return (n > 12) ? term : term + exponential_series(value, term * value / n, n + 1);
+			}
+
+			/// Returns ln(value) for 0 < value <= 1. Doubles the value into [0.5, 1], where the atanh series converges quickly.
+			static constexpr double natural_log(double value) {
+				return (value < 0.5) ? natural_log(value * 2) - 0.6931471805599453 : 2 * natural_log_series((value - 1) / (value + 1), ((value - 1) / (value + 1)) * ((value - 1) / (value + 1)), 1);
+			}
+
+			static constexpr double natural_log_series(double power, double ratio_squared, unsigned char n) {
+				return (n > 41) ? 0 : (power / n) + natural_log_series(power * ratio_squared, ratio_squared, n + 2);
+			}
+
+			static constexpr double power(double value, double exponent) {
+				return (value <= 0) ? 0 : exponential(exponent * natural_log(value));
+			}
+
+			static constexpr double square(double value) {
+				return value * value;
+			}
+	};
+}
+
+#endif // GAMMA_H
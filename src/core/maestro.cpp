@@ -3,11 +3,72 @@
 */
 
 #include "../utility.h"
+#include "gamma.h"
 #include "maestro.h"
 #include "section.h"
 
 namespace PixelMaestro {
 
+	/// Set on the ready frame index when the frame hasn't been read yet.
+	static const unsigned char FRAME_NEW = 0x04;
+
+	/**
+	 * Stores a new value in a shared frame index and returns the old value as a single atomic operation.
+	 * Platforms without threads (e.g. AVR) don't need the atomic version.
+	 * @param index The index to change.
+	 * @param value The new value.
+	 * @return The previous value.
+	 */
+	static unsigned char exchange_frame_index(unsigned char* index, unsigned char value) {
+	#if defined(__GNUC__) && !defined(__AVR__)
+		return __atomic_exchange_n(index, value, __ATOMIC_ACQ_REL);
+	#else
+		unsigned char previous = *index;
+		*index = value;
+		return previous;
+	#endif
+	}
+
+	/**
+	 * Reads a shared frame index.
+	 * @param index The index to read.
+	 * @return The index's value.
+	 */
+	static unsigned char load_frame_index(unsigned char* index) {
+	#if defined(__GNUC__) && !defined(__AVR__)
+		return __atomic_load_n(index, __ATOMIC_ACQUIRE);
+	#else
+		return *index;
+	#endif
+	}
+
+	/// Tags a Section's changed Pixels with the Section's index before passing them to a Maestro::SpanCallback.
+	struct SectionSpanContext {
+		Maestro::SpanCallback callback;
+		unsigned char section;
+		void* context;
+	};
+
+	static void forward_section_span(unsigned int start, unsigned int length, void* context) {
+		SectionSpanContext* section_context = (SectionSpanContext*)context;
+		section_context->callback(section_context->section, start, length, section_context->context);
+	}
+
+	/// Passes the Sections and the current time to each Executor task.
+	struct SectionUpdateContext {
+		Section* sections;
+		unsigned long current_time;
+	};
+
+	static void update_section(unsigned int section, void* context) {
+		SectionUpdateContext* update_context = (SectionUpdateContext*)context;
+
+		// Sections with their own Executor are updated afterwards, since Executors can't run batches inside of other batches.
+		if (update_context->sections[section].get_executor() == nullptr) {
+			update_context->sections[section].update(update_context->current_time);
+		}
+	}
+
 	/**
 	 * Constructor. Creates the Maestro with the specified Sections.
 	 * @param sections Array of Sections to manage.
@@ -17,6 +78,33 @@ namespace PixelMaestro {
 		set_sections(sections, num_sections);
 	}
 
+	/**
+	 * Creates a frame buffer, which lets another thread read completed frames while the Maestro renders the next one.
+	 * After each refresh that changes any Pixels, update() renders the output into the frame buffer and publishes it for get_frame().
+	 * If a frame buffer already exists, it's replaced. If the total number of Pixels changes later (e.g. through set_sections() or Section::set_dimensions()), update() replaces it again.
+	 * Make sure no other thread is reading a frame when the frame buffer is replaced.
+	 * @param order The order to write each Pixel's color channels in.
+	 * @param stride The number of bytes between the start of one Pixel and the start of the next (at least 3).
+	 */
+	void Maestro::add_frame_buffer(Colors::ColorOrder order, unsigned int stride) {
+		remove_frame_buffer();
+
+		frame_order_ = order;
+		frame_stride_ = stride;
+		frame_size_ = get_num_pixels() * stride;
+		for (unsigned char buffer = 0; buffer < 3; buffer++) {
+			frame_buffers_[buffer] = new unsigned char[frame_size_]();
+		}
+		frame_back_ = 0;
+		frame_front_ = 1;
+		frame_ready_ = 2;
+
+		// Render the current state so the first frame is complete.
+		for (unsigned char section = 0; section < num_sections_; section++) {
+			sections_[section].invalidate();
+		}
+	}
+
 	/**
 	 * Creates and configures a Show.
 	 * If a Show already exists, this modifies and returns the existing Show.
@@ -32,6 +120,126 @@ namespace PixelMaestro {
 		return show_;
 	}
 
+	/**
+	 * Runs a callback for each run of Pixels that changed during the last refresh, across all Sections.
+	 * Use this to only send changed Pixels to the output device.
+	 * @param callback Function to run for each run of Pixels. Receives the Section index and the Pixel range within that Section.
+	 * @param context Passed to the callback as-is.
+	 */
+	void Maestro::for_each_dirty_span(SpanCallback callback, void* context) {
+		SectionSpanContext section_context = {callback, 0, context};
+		for (unsigned char section = 0; section < num_sections_; section++) {
+			section_context.section = section;
+			sections_[section].for_each_dirty_span(&forward_section_span, &section_context);
+		}
+	}
+
+	/**
+	 * Returns whether any Section changed during the last refresh.
+	 * If false, the output is the same as the previous refresh and doesn't need to be redrawn.
+	 * @return True if any Pixels changed.
+	 */
+	bool Maestro::get_changed() {
+		// Dithering changes the output on every frame, even if the colors stay the same.
+		if (get_dithered()) {
+			return true;
+		}
+
+		for (unsigned char section = 0; section < num_sections_; section++) {
+			if (sections_[section].get_changed()) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * Returns whether render_frame() dithers the output.
+	 * @return True if dithering is enabled.
+	 */
+	bool Maestro::get_dithering() {
+		return dithering_;
+	}
+
+	/**
+	 * Returns the Executor used to update Sections.
+	 * @return Current Executor, or nullptr if Sections are updated serially.
+	 */
+	Executor* Maestro::get_executor() {
+		return executor_;
+	}
+
+	/**
+	 * Returns the most recent frame that hasn't been read yet.
+	 * The frame stays valid and unchanged until the next call to get_frame(), even while update() renders new frames.
+	 * This can be called from a different thread than update(), but only one thread should call it.
+	 * @return The newest frame, or nullptr if there's no frame buffer or no new frame since the last call.
+	 */
+	unsigned char* Maestro::get_frame() {
+		if (frame_size_ == 0 || !(load_frame_index(&frame_ready_) & FRAME_NEW)) {
+			return nullptr;
+		}
+
+		frame_front_ = exchange_frame_index(&frame_ready_, frame_front_) & ~FRAME_NEW;
+		return frame_buffers_[frame_front_];
+	}
+
+	/**
+	 * Returns the size of each frame in the frame buffer.
+	 * @return Frame size in bytes, or 0 if there's no frame buffer.
+	 */
+	unsigned int Maestro::get_frame_size() {
+		return frame_size_;
+	}
+
+	/**
+		Returns the gamma table applied to the output.
+
+		@return Gamma table, or nullptr if the output isn't corrected.
+	*/
+	const unsigned short* Maestro::get_gamma() {
+		return gamma_;
+	}
+
+	/**
+	 * Returns the earliest time that calling update() will change the output, so the caller can sleep until then instead of calling update() continuously.
+	 * This accounts for the refresh interval, Show Events, Animation cycles, fades, Canvas scrolling, and dithering.
+	 * Changes made directly (e.g. Section::set_one()) appear on the next refresh, so call update() after making them.
+	 * Times wrap around like the runtime does, so compare them by subtracting (e.g. wakeup - current_time) rather than directly.
+	 * @param current_time Program runtime.
+	 * @return Time of the next change. If nothing is scheduled (e.g. the Maestro isn't running), this is the furthest possible time, current_time - 1.
+	 */
+	unsigned long Maestro::get_next_wakeup(const unsigned long& current_time) {
+		unsigned long time = (unsigned long)-1;
+		if (!running_) {
+			return current_time + time;
+		}
+
+		if (show_ != nullptr) {
+			time = show_->get_time_until_event(current_time);
+		}
+
+		// Dithering changes the output on every refresh.
+		if (get_dithered()) {
+			time = 0;
+		}
+
+		for (unsigned char section = 0; section < num_sections_ && time > 0; section++) {
+			unsigned long section_time = sections_[section].get_time_until_change(current_time);
+			if (section_time < time) {
+				time = section_time;
+			}
+		}
+
+		// Nothing changes before the next refresh.
+		unsigned long refresh_time = Utility::time_remaining(last_refresh_, refresh_interval_, current_time);
+		if (time < refresh_time) {
+			time = refresh_time;
+		}
+
+		return current_time + time;
+	}
+
 	/**
 		Returns the number of Sections.
 
@@ -45,10 +253,44 @@ namespace PixelMaestro {
 	 * Returns the color of the specified Pixel in the specified Section after applying post-processing.
 	 * @param section Section to retrieve the Pixel from.
 	 * @param pixel Index of the Pixel to retrieve.
-	 * @return Pixel color after adjusting for Overlays and brightness.
+	 * This is the same as the output from render_frame() without dithering.
+	 * @return Pixel color after adjusting for Overlays, gamma, and brightness.
 	 */
 	Colors::RGB Maestro::get_pixel_color(unsigned char section, unsigned int pixel) {
-		return sections_[section].get_pixel_color(pixel) * (float)(brightness_ / (float)255);
+		// Uses the same output levels as render_frame().
+		Colors::RGB color = sections_[section].get_pixel_color(pixel);
+		if (use_levels_) {
+			color = {(unsigned char)(levels_[color.r] >> 8), (unsigned char)(levels_[color.g] >> 8), (unsigned char)(levels_[color.b] >> 8)};
+		}
+		return color;
+	}
+
+	/**
+		Returns the dithering residuals, reallocating them if the number of Pixels changed.
+
+		@return Residuals for every channel of every Pixel.
+	*/
+	unsigned char* Maestro::get_residuals() {
+		unsigned int num_pixels = get_num_pixels();
+
+		if (num_pixels * 3 != num_residuals_) {
+			delete [] residuals_;
+			num_residuals_ = num_pixels * 3;
+			residuals_ = new unsigned char[num_residuals_];
+
+			/*
+				Start each Pixel at a different point in the cycle.
+				Otherwise, Pixels with the same color would all step up on the same frame and visibly flicker together.
+			*/
+			for (unsigned int pixel = 0; pixel < num_pixels; pixel++) {
+				unsigned char residual = pixel * 97;
+				residuals_[pixel * 3] = residual;
+				residuals_[(pixel * 3) + 1] = residual;
+				residuals_[(pixel * 3) + 2] = residual;
+			}
+		}
+
+		return residuals_;
 	}
 
 	/**
@@ -79,6 +321,40 @@ namespace PixelMaestro {
 		return &sections_[section];
 	}
 
+	/**
+		Returns whether render_frame() dithers the output.
+		Without levels, colors are output unchanged, so there's only something to dither if a Section keeps the low byte of each channel (HIGH_PRECISION mode).
+
+		@return True if the output is dithered.
+	*/
+	bool Maestro::get_dithered() {
+		if (!dithering_) {
+			return false;
+		}
+		if (use_levels_) {
+			return true;
+		}
+		for (unsigned char section = 0; section < num_sections_; section++) {
+			if (sections_[section].get_storage_mode() == Section::StorageMode::HIGH_PRECISION) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+		Returns the total number of Pixels across all Sections.
+
+		@return Number of Pixels.
+	*/
+	unsigned int Maestro::get_num_pixels() {
+		unsigned int num_pixels = 0;
+		for (unsigned char section = 0; section < num_sections_; section++) {
+			num_pixels += sections_[section].get_dimensions()->size();
+		}
+		return num_pixels;
+	}
+
 	/**
 	 * Returns the current Show.
 	 * @return Active Show.
@@ -87,12 +363,78 @@ namespace PixelMaestro {
 		return show_;
 	}
 
+	/**
+	 * Deletes the frame buffer.
+	 * Make sure no other thread is reading a frame before calling this.
+	 */
+	void Maestro::remove_frame_buffer() {
+		for (unsigned char buffer = 0; buffer < 3; buffer++) {
+			delete [] frame_buffers_[buffer];
+			frame_buffers_[buffer] = nullptr;
+		}
+		frame_size_ = 0;
+	}
+
+	/**
+	 * Writes the final color of every Pixel in every Section into a buffer, applying gamma and global brightness.
+	 * Sections are written one after the other in the order they were added.
+	 * This is the preferred way to retrieve output: it replaces a get_pixel_color() call per Pixel with a single pass per Section.
+	 * While dithering, each call renders the next frame in the dithering cycle.
+	 * @param buffer Buffer to write to. Must hold at least (total number of Pixels * stride) bytes.
+	 * @param order The order to write each Pixel's color channels in.
+	 * @param stride The number of bytes between the start of one Pixel and the start of the next (at least 3).
+	 */
+	void Maestro::render_frame(unsigned char* buffer, Colors::ColorOrder order, unsigned int stride) {
+		unsigned char* residuals = get_dithered() ? get_residuals() : nullptr;
+		const unsigned short* levels = use_levels_ ? levels_ : nullptr;
+
+		for (unsigned char section = 0; section < num_sections_; section++) {
+			unsigned int num_pixels = sections_[section].get_dimensions()->size();
+			sections_[section].render_frame(buffer, order, stride, levels, residuals);
+			buffer += num_pixels * stride;
+			if (residuals != nullptr) {
+				residuals += num_pixels * 3;
+			}
+		}
+	}
+
 	/**
 	 * Sets the Maestro's global brightness level.
+	 * If update() runs on another thread, a frame rendered during this call may mix the old and new levels. Call it from the update thread to avoid this.
 	 * @param brightness Brightness level from 0 (off) to 255 (full).
 	 */
 	void Maestro::set_brightness(unsigned char brightness) {
+		// Brightness affects every Pixel, so redraw everything.
+		if (brightness != brightness_) {
+			for (unsigned char section = 0; section < num_sections_; section++) {
+				sections_[section].invalidate();
+			}
+		}
 		brightness_ = brightness;
+		update_levels();
+	}
+
+	/**
+	 * Sets whether render_frame() dithers the output over time.
+	 * Gamma and brightness produce levels between the 8-bit output values, which are normally rounded down.
+	 * Dithering carries the remainder of each channel over to the next frame, so the average output over several frames matches the level exactly.
+	 * This keeps dim colors and slow fades smooth, especially at low brightness. It uses 3 bytes per Pixel.
+	 * Sections in HIGH_PRECISION mode also fade between 8-bit colors, and dithering recovers those steps too, even without gamma or brightness.
+	 * Since the output changes every frame, get_changed() always returns true while dithering, and render_frame() should be called on every refresh.
+	 * @param dithering Whether to dither the output.
+	 */
+	void Maestro::set_dithering(bool dithering) {
+		dithering_ = dithering;
+	}
+
+	/**
+	 * Sets the Executor used to update Sections (e.g. a ThreadPool).
+	 * Each Section, along with its Overlay and Canvas, is updated as a separate task. Sections must not share Animations when using an Executor.
+	 * The Maestro doesn't take ownership of the Executor.
+	 * @param executor New Executor, or nullptr to update Sections serially.
+	 */
+	void Maestro::set_executor(Executor* executor) {
+		executor_ = executor;
 	}
 
 	/**
@@ -131,8 +473,9 @@ namespace PixelMaestro {
 		Main update routine.
 
 		@param current_time Program runtime.
+		@return True if the Sections were refreshed. Use get_changed() to check whether the refresh changed any Pixels.
 	*/
-	void Maestro::update(const unsigned long& current_time) {
+	bool Maestro::update(const unsigned long& current_time) {
 		// If running, call each Section's update method.
 		if (running_) {
 
@@ -144,18 +487,93 @@ namespace PixelMaestro {
 					show_->update(current_time);
 				}
 
-				// Update each Section
-				for (unsigned char section = 0; section < num_sections_; section++) {
-					sections_[section].update(current_time);
+				/*
+				 * Update each Section.
+				 * With an Executor, Sections update concurrently and run() returns once all of them are done.
+				 * The frame is only read out afterwards (e.g. by render_frame()), so the output is the same either way.
+				 */
+				if (executor_ != nullptr) {
+					SectionUpdateContext context = {sections_, current_time};
+					executor_->run(&update_section, &context, num_sections_);
+
+					for (unsigned char section = 0; section < num_sections_; section++) {
+						if (sections_[section].get_executor() != nullptr) {
+							sections_[section].update(current_time);
+						}
+					}
+				}
+				else {
+					for (unsigned char section = 0; section < num_sections_; section++) {
+						sections_[section].update(current_time);
+					}
+				}
+
+				/*
+				 * Render and publish the new frame.
+				 * If nothing changed, the last published frame is still current.
+				 * If the Sections changed size, the frame buffer no longer fits the output, so it's replaced and fully rendered.
+				 */
+				if (frame_size_ > 0) {
+					bool resized = (get_num_pixels() * frame_stride_ != frame_size_);
+					if (resized) {
+						add_frame_buffer(frame_order_, frame_stride_);
+					}
+
+					if (resized || get_changed()) {
+						render_frame(frame_buffers_[frame_back_], frame_order_, frame_stride_);
+						frame_back_ = exchange_frame_index(&frame_ready_, frame_back_ | FRAME_NEW) & ~FRAME_NEW;
+					}
 				}
 
 				// Update the last refresh time.
 				last_refresh_ = current_time;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/**
+		Sets the gamma table applied to the output.
+		The table is combined with the global brightness, so applying it costs a single lookup per channel.
+		Use one of the tables in Gamma (e.g. Gamma::CIE_LIGHTNESS), or build your own with PIXELMAESTRO_GAMMA_TABLE. The Maestro doesn't copy the table.
+		As with set_brightness(), call this from the thread that runs update() to avoid a frame that mixes the old and new levels.
+
+		@param curve Table of 256 output levels (see Gamma), or nullptr to output colors uncorrected.
+	*/
+	void Maestro::set_gamma(const unsigned short* curve) {
+		// Gamma affects every Pixel, so redraw everything.
+		if (curve != gamma_) {
+			for (unsigned char section = 0; section < num_sections_; section++) {
+				sections_[section].invalidate();
 			}
 		}
+		gamma_ = curve;
+		update_levels();
+	}
+
+	/**
+		Rebuilds the output levels after the gamma table or brightness changes.
+	*/
+	void Maestro::update_levels() {
+		// With no gamma and full brightness, the output is the same as the input, so skip the lookup entirely.
+		use_levels_ = (gamma_ != nullptr || brightness_ != 255);
+		if (!use_levels_) {
+			return;
+		}
+
+		// Once allocated, the table is only freed by the destructor, so it's never freed while update() renders on another thread.
+		if (levels_ == nullptr) {
+			levels_ = new unsigned short[256];
+		}
+		Gamma::build_levels(levels_, gamma_, brightness_);
 	}
 
 	Maestro::~Maestro() {
+		remove_frame_buffer();
 		delete show_;
+		delete [] levels_;
+		delete [] residuals_;
 	}
 }
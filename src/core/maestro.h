@@ -6,6 +6,7 @@
 #define MAESTRO_H
 
 #include "colors.h"
+#include "executor.h"
 #include "section.h"
 #include "../show/show.h"
 #include "../show/event.h"
@@ -14,42 +15,112 @@ namespace PixelMaestro {
 	class Maestro {
 
 		public:
+			/// Callback used to iterate over changed Pixels. The context parameter is passed through from the caller.
+			typedef void (*SpanCallback)(unsigned char section, unsigned int start, unsigned int length, void* context);
+
 			Maestro(Section* sections, unsigned char num_sections);
 			~Maestro();
+			void add_frame_buffer(Colors::ColorOrder order = Colors::ColorOrder::RGB, unsigned int stride = 3);
 			Show* add_show(Event** events, unsigned short num_events);
+			void for_each_dirty_span(SpanCallback callback, void* context = nullptr);
+			bool get_changed();
+			bool get_dithering();
+			Executor* get_executor();
+			const unsigned short* get_gamma();
+			unsigned char* get_frame();
+			unsigned int get_frame_size();
+			unsigned long get_next_wakeup(const unsigned long& current_time);
 			Colors::RGB get_pixel_color(unsigned char section, unsigned int pixel);
 			unsigned char get_num_sections();
 			unsigned short get_refresh_interval();
 			bool get_running();
 			Section* get_section(unsigned char section);
 			Show* get_show();
+			void remove_frame_buffer();
+			void render_frame(unsigned char* buffer, Colors::ColorOrder order = Colors::ColorOrder::RGB, unsigned int stride = 3);
 			void set_brightness(unsigned char brightness);
+			void set_dithering(bool dithering);
+			void set_executor(Executor* executor);
+			void set_gamma(const unsigned short* curve);
 			void set_refresh_interval(unsigned short interval);
 			void set_running(bool running);
 			void set_sections(Section* sections, unsigned char num_sections);
-			void update(const unsigned long& current_time);
+			bool update(const unsigned long& current_time);
 
 		private:
 			/// Sets the global brightness level from 0 - 255. Defaults to 255, or 100% brightness.
 			unsigned char brightness_ = 255;
 
+			/// Whether render_frame() dithers the output over time.
+			bool dithering_ = false;
+
+			/// Runs Section updates. If not set, Sections are updated one at a time on the calling thread.
+			Executor* executor_ = nullptr;
+
+			/// The gamma table applied to the output. If not set, colors are output uncorrected.
+			const unsigned short* gamma_ = nullptr;
+
+			/// The output level of each channel value after applying gamma and brightness, in 8.8 fixed point. Allocated the first time gamma or brightness is set.
+			unsigned short* levels_ = nullptr;
+
+			/*
+				The frame buffer keeps three copies of the rendered output so that update() and get_frame() never wait on each other.
+				update() renders into the back buffer, then swaps it with the ready buffer. get_frame() swaps the ready buffer with the front buffer.
+				The ready index is the only value shared between threads, and is always exchanged atomically.
+			*/
+
+			/// Index of the buffer that update() renders into.
+			unsigned char frame_back_ = 0;
+
+			/// The frame buffers. Unallocated until add_frame_buffer() is called.
+			unsigned char* frame_buffers_[3] = {nullptr, nullptr, nullptr};
+
+			/// Index of the buffer returned by the last call to get_frame().
+			unsigned char frame_front_ = 1;
+
+			/// The channel order used when rendering into the frame buffer.
+			Colors::ColorOrder frame_order_ = Colors::ColorOrder::RGB;
+
+			/// Index of the most recently completed frame. If FRAME_NEW is set, the frame hasn't been read yet.
+			unsigned char frame_ready_ = 2;
+
+			/// The size of each frame buffer in bytes.
+			unsigned int frame_size_ = 0;
+
+			/// The stride used when rendering into the frame buffer.
+			unsigned int frame_stride_ = 3;
+
 			/// The time since the Pixels were last refreshed in milliseconds. Defaults to 0.
 			unsigned long last_refresh_ = 0;
 
 			/// Number of Sections managed by the Maestro.
 			unsigned char num_sections_;
 
+			/// The size of residuals_ in bytes.
+			unsigned int num_residuals_ = 0;
+
 			/// The time between Section refreshes in milliseconds. Defaults to 20ms (50Hz).
 			unsigned short refresh_interval_ = 20;
 
+			/// The fraction of each channel's level carried over to the next frame while dithering. Allocated by render_frame() and kept until the Maestro is destroyed.
+			unsigned char* residuals_ = nullptr;
+
 			/// Active running state of the Maestro.
 			bool running_ = true;
 
 			/// Sections managed by the Maestro.
 			Section* sections_ = nullptr;
 
+			/// Whether levels_ is applied to the output. False while the output is unchanged (no gamma and full brightness).
+			bool use_levels_ = false;
+
 			/// Show managed by the Maestro.
 			Show* show_ = nullptr;
+
+			bool get_dithered();
+			unsigned int get_num_pixels();
+			unsigned char* get_residuals();
+			void update_levels();
 	};
 }
 
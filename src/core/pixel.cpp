@@ -3,7 +3,6 @@
 	Inspired by RGBMood (http://forum.arduino.cc/index.php?topic=90160.0)
 */
 
-#include "../utility.h"
 #include "colors.h"
 #include "pixel.h"
 
@@ -22,67 +21,43 @@ namespace PixelMaestro {
 
 		@param color New color to store.
 		@param fade Whether to fade to the next color.
-		@param cycle_interval The amount of time to go from the current color to next_color.
-		@param refresh_rate The refresh rate of the section. Used to calculate color events (if fading).
+		@param fade_interval The amount of time (in milliseconds) to go from the current color to next_color.
+		@param current_time The program's current runtime. Marks the start of the fade.
 	*/
-	void Pixel::set_next_color(Colors::RGB* next_color, bool fade, unsigned short cycle_interval, unsigned short refresh_rate) {
+	void Pixel::set_next_color(Colors::RGB* next_color, bool fade, unsigned short fade_interval, const unsigned long& current_time) {
 		// Only trigger an update if the colors don't match.
 		if (next_color != next_color_) {
 			next_color_ = next_color;
 
 			/*
-				If fading, calculate the steps between the current color and the next color.
-				Use the refresh rate to determine the number of steps to take during the event.
+				If fading, remember where the fade starts from and when.
+				The color at any point during the fade is calculated from the time elapsed since then.
 			*/
 			if (fade) {
-				float diff = cycle_interval / (float)refresh_rate;
-				step_ = {
-					(unsigned char)(Utility::abs_int(next_color_->r - current_color_.r) / diff),
-					(unsigned char)(Utility::abs_int(next_color_->g - current_color_.g) / diff),
-					(unsigned char)(Utility::abs_int(next_color_->b - current_color_.b) / diff)
-				};
-				step_count_ = diff;
+				previous_color_ = current_color_;
+				fade_start_ = current_time;
+				fade_duration_ = fade_interval;
 			}
 			else {
-				step_count_ = 0;
+				fade_duration_ = 0;
 			}
 		}
 	}
 
 	/**
 		Main update routine.
+
+		@param current_time The program's current runtime.
 	*/
-	void Pixel::update() {
+	void Pixel::update(const unsigned long& current_time) {
 		/*
-		 * If fading, run through each step and add (or subtract) the step amount.
-		 * At the end of the run (or if we're not fading), set current_color_ = next_color_.
+		 * If fading, calculate how far along the fade we are and blend between the previous and next colors.
+		 * Because this is based on time rather than on the number of updates, late or skipped updates don't change the fade's speed.
+		 * At the end of the fade (or if we're not fading), set current_color_ = next_color_.
 		 */
-		if (step_count_ > 0) {
-			// Red
-			if (next_color_->r > current_color_.r) {
-				current_color_.r += step_.r;
-			}
-			else if (next_color_->r < current_color_.r) {
-				current_color_.r -= step_.r;
-			}
-
-			// Green
-			if (next_color_->g > current_color_.g) {
-				current_color_.g += step_.g;
-			}
-			else if (next_color_->g < current_color_.g) {
-				current_color_.g -= step_.g;
-			}
-
-			// Blue
-			if (next_color_->b > current_color_.b) {
-				current_color_.b += step_.b;
-			}
-			else if (next_color_->b < current_color_.b) {
-				current_color_.b -= step_.b;
-			}
-
-			step_count_--;
+		unsigned long elapsed = current_time - fade_start_;
+		if (elapsed < fade_duration_) {
+			current_color_ = Colors::interpolate(&previous_color_, next_color_, Colors::get_fade_progress(elapsed, fade_duration_));
 		}
 		else {
 			current_color_ = *next_color_;
@@ -13,8 +13,8 @@ namespace PixelMaestro {
 
 		public:
 			Colors::RGB* get_color();
-			void set_next_color(Colors::RGB* next_color, bool fade, unsigned short cycle_speed, unsigned short refresh_rate);
-			void update();
+			void set_next_color(Colors::RGB* next_color, bool fade, unsigned short fade_interval, const unsigned long& current_time);
+			void update(const unsigned long& current_time);
 
 		private:
 			/// The Pixel's current color. Defaults to BLACK.
@@ -23,11 +23,14 @@ namespace PixelMaestro {
 			/// The Pixel's next (i.e. target) color.
 			Colors::RGB* next_color_ = &Colors::BLACK;
 
-			/// The size of each step from current_color_ to next_color_ (only applicable when fading).
-			Colors::RGB step_ = Colors::BLACK;
+			/// The color the Pixel started fading from (only applicable when fading).
+			Colors::RGB previous_color_ = Colors::BLACK;
 
-			/// The number of steps from current_color_ to next_color_ (only applicable when fading).
-			unsigned char step_count_ = 0;
+			/// The amount of time (in milliseconds) to fade from previous_color_ to next_color_ (only applicable when fading).
+			unsigned short fade_duration_ = 0;
+
+			/// The time (in milliseconds) that the current fade started (only applicable when fading).
+			unsigned long fade_start_ = 0;
 
 	};
 }
@@ -0,0 +1,108 @@
+/*
+ * Random - Seedable pseudo-random number generator.
+ */
+
+#include "random.h"
+
+namespace PixelMaestro {
+	/**
+	 * Constructor.
+	 * @param seed Initial seed.
+	 */
+	Random::Random(unsigned long seed) {
+		set_seed(seed);
+	}
+
+	/**
+	 * Fills a buffer with random bytes.
+	 * @param buffer Buffer to fill.
+	 * @param size Number of bytes to fill.
+	 */
+	void Random::fill(unsigned char* buffer, unsigned int size) {
+		unsigned int index = 0;
+
+		// Use all four bytes of each number.
+		unsigned long value;
+		for (; index + 4 <= size; index += 4) {
+			value = next();
+			buffer[index] = value;
+			buffer[index + 1] = value >> 8;
+			buffer[index + 2] = value >> 16;
+			buffer[index + 3] = value >> 24;
+		}
+
+		for (; index < size; index++) {
+			buffer[index] = next_byte();
+		}
+	}
+
+	/**
+	 * Fills a mask where each entry is set to 1 with a probability of (threshold + 1) / 256, and 0 otherwise.
+	 * @param mask Mask to fill.
+	 * @param size Number of entries to fill.
+	 * @param threshold Activation threshold (0 - 255).
+	 */
+	void Random::fill_mask(unsigned char* mask, unsigned int size, unsigned char threshold) {
+		fill(mask, size);
+		for (unsigned int index = 0; index < size; index++) {
+			mask[index] = (mask[index] <= threshold);
+		}
+	}
+
+	/**
+	 * Generates the next random number.
+	 * See https://en.wikipedia.org/wiki/Xorshift
+	 * @return Random 32-bit value.
+	 */
+	unsigned long Random::next() {
+		// Masking keeps the generator 32-bit on platforms where longs are wider.
+		state_ ^= (state_ << 13) & 0xFFFFFFFF;
+		state_ ^= state_ >> 17;
+		state_ ^= (state_ << 5) & 0xFFFFFFFF;
+		return state_;
+	}
+
+	/**
+	 * Generates a random byte. Each call to next() provides four bytes.
+	 * @return Random byte.
+	 */
+	unsigned char Random::next_byte() {
+		if (num_bytes_ == 0) {
+			bytes_ = next();
+			num_bytes_ = 4;
+		}
+
+		unsigned char byte = bytes_;
+		bytes_ >>= 8;
+		num_bytes_--;
+		return byte;
+	}
+
+	/**
+	 * Generates a random number from 0 up to (but not including) max.
+	 * Uses a multiply and shift instead of a modulo, which avoids a division.
+	 * @param max Upper limit.
+	 * @return Random value.
+	 */
+	unsigned short Random::next_range(unsigned short max) {
+		return ((next() >> 16) * max) >> 16;
+	}
+
+	/**
+	 * Restarts the generator from a new seed.
+	 * @param seed New seed.
+	 */
+	void Random::set_seed(unsigned long seed) {
+		// Scramble the seed so that similar seeds (e.g. 1 and 2) start far apart. The generator can't start from 0.
+		state_ = (seed * 2654435761UL) & 0xFFFFFFFF;
+		if (state_ == 0) {
+			state_ = 2463534242UL;
+		}
+		num_bytes_ = 0;
+
+		// Discard the first few numbers, which stay close to the scrambled seed.
+		for (unsigned char i = 0; i < 4; i++) {
+			next();
+		}
+	}
+}
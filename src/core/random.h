@@ -0,0 +1,36 @@
+/*
+ * Random - Seedable pseudo-random number generator.
+ */
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+namespace PixelMaestro {
+	/**
+		Generates pseudo-random numbers using a 32-bit xorshift generator.
+		Each Random object is an independent stream, so objects updated on different threads don't share state.
+		Two objects with the same seed always generate the same sequence.
+	*/
+	class Random {
+		public:
+			Random(unsigned long seed = 1);
+			void fill(unsigned char* buffer, unsigned int size);
+			void fill_mask(unsigned char* mask, unsigned int size, unsigned char threshold);
+			unsigned long next();
+			unsigned char next_byte();
+			unsigned short next_range(unsigned short max);
+			void set_seed(unsigned long seed);
+
+		private:
+			/// Random bytes left over from the last call to next().
+			unsigned long bytes_ = 0;
+
+			/// The number of bytes left in bytes_.
+			unsigned char num_bytes_ = 0;
+
+			/// The generator's state. Never 0.
+			unsigned long state_;
+	};
+}
+
+#endif // RANDOM_H
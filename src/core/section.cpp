@@ -1,14 +1,64 @@
 /*
 	Section.cpp - Class for controlling multiple Pixels.
-	Requires Pixel and Colors classes.
+	Requires Colors class.
 */
 
+#include <string.h>
 #include "colors.h"
-#include "pixel.h"
 #include "section.h"
 
 namespace PixelMaestro {
 
+	/// Changes are tracked in blocks of (1 << BLOCK_SHIFT) Pixels. A block's index is its first Pixel's index >> BLOCK_SHIFT.
+	static const unsigned char BLOCK_SHIFT = 4;
+
+	/**
+		The number of bands to aim for when splitting a Section across an Executor.
+		Using more bands than threads lets threads that finish early pick up bands that are slower to render.
+	*/
+	static const unsigned char TARGET_BANDS = 64;
+
+	// Static members used as values elsewhere (e.g. by reference) need a definition.
+	const unsigned char Section::INDEX_OFF;
+
+	/**
+		Returns the 8.8 fixed-point output level of a channel, including its low byte (HIGH_PRECISION mode only).
+		Levels between two table entries are interpolated.
+
+		@param levels Table of 256 output levels, or nullptr to output the channel unchanged.
+		@param value The channel's value.
+		@param fraction The channel's low byte.
+		@return Output level.
+	*/
+	static inline unsigned short get_fine_level(const unsigned short* levels, unsigned char value, unsigned char fraction) {
+		if (levels == nullptr) {
+			return (value << 8) | fraction;
+		}
+
+		// Fades never go past 255, so a channel with a low byte is always less than 255.
+		if (fraction == 0) {
+			return levels[value];
+		}
+		return ((levels[value] * (unsigned long)(256 - fraction)) + (levels[value + 1] * (unsigned long)fraction)) >> 8;
+	}
+
+	/// Passes the Section, Animation, and band size to each row band.
+	struct RowBandContext {
+		Section* section;
+		Animation* animation;
+		unsigned short band_rows;
+	};
+
+	static void update_row_band(unsigned int band, void* context) {
+		RowBandContext* band_context = (RowBandContext*)context;
+		unsigned short start_row = band * band_context->band_rows;
+		unsigned short end_row = start_row + band_context->band_rows;
+		if (end_row > band_context->section->get_dimensions()->y) {
+			end_row = band_context->section->get_dimensions()->y;
+		}
+		band_context->animation->update_rows(band_context->section, start_row, end_row);
+	}
+
 	/**
 	 * Constructor. Initializes the Pixel array.
 	 * @param dimensions Initial layout (rows and columns) of the Pixels.
@@ -39,18 +89,112 @@ namespace PixelMaestro {
 	}
 
 	/**
-	 * Creates a new Overlay.
+		Adds a new Overlay to the top of the layer stack using the mix mode's default opacity (see get_default_alpha()).
+
+		@param mix_mode The method for blending the Overlay with the layers below it.
+		@return New Overlay, or nullptr if the stack is full (255 layers).
+	*/
+	Section::Overlay* Section::add_layer(Colors::MixMode mix_mode) {
+		return add_layer(mix_mode, get_default_alpha(mix_mode));
+	}
+
+	/**
+		Adds a new Overlay to the top of the layer stack.
+
+		@param mix_mode The method for blending the Overlay with the layers below it.
+		@param alpha The Overlay's opacity (0 - 255).
+		@return New Overlay, or nullptr if the stack is full (255 layers).
+	*/
+	Section::Overlay* Section::add_layer(Colors::MixMode mix_mode, unsigned char alpha) {
+		if (num_layers_ == 255) {
+			return nullptr;
+		}
+
+		Overlay** layers = new Overlay*[num_layers_ + 1];
+		for (unsigned char index = 0; index < num_layers_; index++) {
+			layers[index] = layers_[index];
+		}
+		delete [] layers_;
+		layers_ = layers;
+
+		Overlay* layer = new Overlay(dimensions_, mix_mode, alpha);
+		layer->last_mix_mode = mix_mode;
+		layer->last_alpha = alpha;
+		layer->section->set_refresh_interval(refresh_interval_);
+		layer->section->set_executor(executor_);
+		layers_[num_layers_] = layer;
+		num_layers_++;
+
+		invalidate();
+		return layer;
+	}
+
+	/**
+	 * Creates a new Overlay using the mix mode's default opacity (see get_default_alpha()). If the Section already has one or more layers, this returns the bottom layer instead.
+	 * @param mix_mode The method for blending the Overlay.
+	 * @return New Overlay.
+	 */
+	Section::Overlay* Section::add_overlay(Colors::MixMode mix_mode) {
+		return add_overlay(mix_mode, get_default_alpha(mix_mode));
+	}
+
+	/**
+	 * Creates a new Overlay. If the Section already has one or more layers, this returns the bottom layer instead.
 	 * @param mix_mode The method for blending the Overlay.
-	 * @param alpha The Overlay's transparency (0 - 255.
+	 * @param alpha The Overlay's opacity (0 - 255).
 	 * @return New Overlay.
 	 */
 	Section::Overlay* Section::add_overlay(Colors::MixMode mix_mode, unsigned char alpha) {
-		if (overlay_ == nullptr) {
-			overlay_ = new Overlay(dimensions_, mix_mode, alpha);
+		if (num_layers_ == 0) {
+			return add_layer(mix_mode, alpha);
+		}
+
+		layers_[0]->section->set_refresh_interval(refresh_interval_);
+		layers_[0]->section->set_executor(executor_);
+		invalidate();
+		return layers_[0];
+	}
+
+	/**
+		Blends the visible layers onto a run of Pixels.
+		If no layers are visible, this may return the Section's own color array instead of writing to output.
+
+		@param start Index of the first Pixel.
+		@param count Number of Pixels.
+		@param output Array of at least count colors to write the result to.
+		@param buffer Array of at least count colors used to read the layers.
+		@return The blended colors.
+	*/
+	Colors::RGB* Section::composite(unsigned int start, unsigned int count, Colors::RGB* output, Colors::RGB* buffer) {
+		Colors::RGB* colors = get_raw_span(start, count, output);
+		for (unsigned char index = 0; index < num_layers_; index++) {
+			Overlay* layer = layers_[index];
+			if (!layer->visible || layer->mix_mode == Colors::MixMode::NONE) {
+				continue;
+			}
+
+			// Blend into output so that the Section's own colors are left untouched.
+			Colors::RGB* layer_colors = layer->section->get_raw_span(start, count, buffer);
+			Colors::mix_span(colors, layer_colors, output, count, layer->mix_mode, layer->alpha);
+			colors = output;
 		}
 
-		overlay_->section->set_refresh_interval(refresh_interval_);
-		return overlay_;
+		return colors;
+	}
+
+	/**
+		Runs a callback for each run of Pixels that changed during the last update.
+		Adjacent changed Pixels are merged into a single run, including runs that cross rows.
+
+		@param callback Function to run for each run of Pixels.
+		@param context Passed to the callback as-is.
+	*/
+	void Section::for_each_dirty_span(SpanCallback callback, void* context) {
+		Span span;
+		unsigned int block = 0;
+		while (find_span(changed_blocks_, block, get_num_blocks(), &span)) {
+			callback(span.start, span.length, context);
+		}
 	}
 
 	/**
@@ -70,6 +214,27 @@ namespace PixelMaestro {
 		return canvas_;
 	}
 
+	/**
+		Returns whether any Pixels changed during the last update.
+		If false, the output is the same as the previous update and doesn't need to be redrawn.
+
+		@return True if any Pixels changed.
+	*/
+	bool Section::get_changed() {
+		return changed_;
+	}
+
+	/**
+		Returns the opacity given to new Overlays when none is specified.
+		ALPHA Overlays default to an even mix (128). Every other mix mode defaults to fully applied (255), which matches how they were drawn before alpha applied to them.
+
+		@param mix_mode The Overlay's mix mode.
+		@return Default opacity (0 - 255).
+	*/
+	unsigned char Section::get_default_alpha(Colors::MixMode mix_mode) {
+		return (mix_mode == Colors::MixMode::ALPHA) ? 128 : 255;
+	}
+
 	/**
 		Returns the size of the Pixel grid.
 
@@ -80,46 +245,107 @@ namespace PixelMaestro {
 	}
 
 	/**
-	 * Returns the Overlay (if one exists).
-	 *
-	 * @return Active Overlay.
-	 */
-	Section::Overlay* Section::get_overlay() {
-		return overlay_;
+		Stores each run of Pixels that changed during the last update.
+		If there are more runs than max_spans, the last span is extended to cover the remaining runs.
+
+		@param spans Array to store the runs in.
+		@param max_spans The size of the array.
+		@return The number of runs stored.
+	*/
+	unsigned int Section::get_dirty_spans(Span* spans, unsigned int max_spans) {
+		if (max_spans == 0) {
+			return 0;
+		}
+
+		Span span;
+		unsigned int block = 0;
+		unsigned int num_spans = 0;
+		while (find_span(changed_blocks_, block, get_num_blocks(), &span)) {
+			if (num_spans < max_spans) {
+				spans[num_spans] = span;
+				num_spans++;
+			}
+			else {
+				spans[num_spans - 1].length = (span.start + span.length) - spans[num_spans - 1].start;
+			}
+		}
+
+		return num_spans;
+	}
+
+	/**
+		Returns the Executor used to split updates into bands.
+
+		@return Current Executor, or nullptr if the Section updates on a single thread.
+	*/
+	Executor* Section::get_executor() {
+		return executor_;
 	}
 
 	/**
-		Returns the Pixel at the specified index.
+		Returns the palette index of each Pixel as a contiguous array.
 
-		@param pixel The index of the Pixel in the pixels_ array.
+		@return Array of Pixel indices, or nullptr if the Section isn't in INDEXED mode.
 	*/
-	Pixel* Section::get_pixel(unsigned int pixel) {
-		return &pixels_[pixel];
+	unsigned char* Section::get_indices() {
+		return indices_;
 	}
 
 	/**
-		Returns the final color of the specified Pixel after applying post-processing effects (e.g. Overlays).
+		Returns the Overlay at the specified position in the layer stack.
+
+		@param index Position in the stack, where 0 is the bottom layer.
+		@return Overlay, or nullptr if the index is out of range.
+	*/
+	Section::Overlay* Section::get_layer(unsigned char index) {
+		if (index >= num_layers_) {
+			return nullptr;
+		}
+		return layers_[index];
+	}
+
+	/**
+		Returns the number of Overlays in the layer stack.
+
+		@return Number of layers.
+	*/
+	unsigned char Section::get_num_layers() {
+		return num_layers_;
+	}
+
+	/**
+	 * Returns the bottom Overlay (if one exists).
+	 *
+	 * @return Active Overlay.
+	 */
+	Section::Overlay* Section::get_overlay() {
+		return get_layer(0);
+	}
+
+	/**
+		Returns the final color of the specified Pixel after applying post-processing effects (e.g. layers).
 
 		@param pixel Index of the Pixel.
 		@return RGB value of the Pixel's final color.
 	*/
 	Colors::RGB Section::get_pixel_color(unsigned int pixel) {
 		// Overlay the Canvas, if one is set
-		if (canvas_ != nullptr) {
+		if (canvas_ != nullptr && canvas_->get_mode() == Canvas::Mode::MASK) {
 			// If the same pixel hasn't been drawn, return black. Otherwise, fall through to the next check.
 			if (canvas_->get_pattern_index(pixel) == 0) {
 				return Colors::BLACK;
 			}
 		}
 
-		// Check the Overlay. If one is set, mix the Overlay with the current Section.
-		if (overlay_ != nullptr) {
-			return Colors::mix_colors(pixels_[pixel].get_color(), overlay_->section->get_pixel(pixel)->get_color(), overlay_->mix_mode, overlay_->alpha);
-		}
-		// No Overlay set, return the raw color.
-		else {
-			return *pixels_[pixel].get_color();
+		// Blend each layer onto the current Section.
+		Colors::RGB output, buffer;
+		Colors::RGB color = *composite(pixel, 1, &output, &buffer);
+
+		// Draw a color Canvas on top.
+		if (canvas_ != nullptr && canvas_->get_mode() == Canvas::Mode::COLOR) {
+			canvas_->blend_pixel(pixel, &color);
 		}
+		return color;
 	}
 
 	/**
@@ -142,29 +368,251 @@ namespace PixelMaestro {
 		return (y * dimensions_.x) + x;
 	}
 
+	/**
+		Returns the number of colors that the palette is rotated by (INDEXED mode only).
+
+		@return Palette offset.
+	*/
+	unsigned char Section::get_palette_offset() {
+		return palette_offset_;
+	}
+
+	/**
+		Returns the current color of each Pixel as a contiguous array.
+		These are raw colors: the Canvas and Overlay are not applied.
+
+		@return Array of current Pixel colors, or nullptr if the Section is in INDEXED mode.
+	*/
+	Colors::RGB* Section::get_pixels() {
+		return pixels_;
+	}
+
 	/**
 		Returns the Section's refresh rate.
 
-		@return The refresh rate of the Section.
+		@return The refresh rate of the Section, or 0 if the Section isn't attached to a Maestro.
 	*/
 	unsigned short Section::get_refresh_interval() {
+		// Sections that aren't attached to a Maestro have no refresh rate.
+		if (refresh_interval_ == nullptr) {
+			return 0;
+		}
 		return *refresh_interval_;
 	}
 
+	/**
+		Returns the method used to store Pixel colors.
+
+		@return Storage mode.
+	*/
+	Section::StorageMode Section::get_storage_mode() {
+		return storage_mode_;
+	}
+
+	/**
+		Returns the time until the Section's next update changes any Pixels.
+		This covers fades, Animation cycles, Canvas scrolling, and layers. Changes made directly (e.g. using set_one()) aren't included.
+
+		@param current_time The program's current runtime.
+		@return Time until the next change (in ms), 0 if the next update changes Pixels, or the longest possible time if the Section won't change on its own.
+	*/
+	unsigned long Section::get_time_until_change(const unsigned long& current_time) {
+		// Without an Animation, update() doesn't update anything.
+		if (animation_ == nullptr) {
+			return (unsigned long)-1;
+		}
+
+		// Fading Pixels change on every update.
+		if ((storage_mode_ != StorageMode::INDEXED && num_fading_pixels_ > 0) || (storage_mode_ == StorageMode::INDEXED && palette_fading_)) {
+			return 0;
+		}
+
+		unsigned long time = animation_->get_time_until_cycle(current_time);
+		if (canvas_ != nullptr) {
+			unsigned long canvas_time = canvas_->get_time_until_change(current_time);
+			if (canvas_time < time) {
+				time = canvas_time;
+			}
+		}
+		for (unsigned char index = 0; index < num_layers_; index++) {
+			unsigned long layer_time = layers_[index]->section->get_time_until_change(current_time);
+			if (layer_time < time) {
+				time = layer_time;
+			}
+		}
+		return time;
+	}
+
+	/**
+		Marks every Pixel as changed, forcing the entire Section to be redrawn after the next update.
+		Use this after changing something that affects the output but isn't tracked by the Section, such as the Overlay's mix mode.
+	*/
+	void Section::invalidate() {
+		memset(pending_blocks_, 1, get_num_blocks());
+		pending_ = true;
+	}
+
 	/**
 	 * Deletes the current Canvas.
 	 */
 	void Section::remove_canvas() {
+		if (canvas_ != nullptr) {
+			invalidate();
+		}
 		delete canvas_;
 		canvas_ = nullptr;
 	}
 
 	/**
-	 * Deletes the current Overlay.
+		Deletes the Overlay at the specified position in the layer stack. Layers above it move down one position.
+
+		@param index Position in the stack, where 0 is the bottom layer.
+	*/
+	void Section::remove_layer(unsigned char index) {
+		if (index >= num_layers_) {
+			return;
+		}
+
+		delete layers_[index];
+		num_layers_--;
+		for (unsigned char layer = index; layer < num_layers_; layer++) {
+			layers_[layer] = layers_[layer + 1];
+		}
+
+		if (num_layers_ == 0) {
+			delete [] layers_;
+			layers_ = nullptr;
+		}
+		invalidate();
+	}
+
+	/**
+	 * Deletes the bottom Overlay.
 	 */
 	void Section::remove_overlay() {
-		delete overlay_;
-		overlay_ = nullptr;
+		remove_layer(0);
+	}
+
+	/**
+		Writes the final color of every Pixel into a buffer in a single pass.
+		This applies the Canvas and layers in the same way as get_pixel_color(), but composites the layers a run of Pixels at a time.
+		Each channel is then mapped through the output levels, which combine gamma and brightness (see Gamma::build_levels()).
+		Without residuals, each channel outputs the integer part of its level.
+		With residuals, the fraction left over from the last frame is added first, and the new fraction is carried over to the next frame.
+		Over several frames, the average output then matches the level exactly (temporal dithering).
+		In HIGH_PRECISION mode, dithering also recovers the low byte of each channel, even without levels.
+
+		@param buffer Buffer to write to. Must hold at least (number of Pixels * stride) bytes.
+		@param order The order to write each Pixel's color channels in.
+		@param stride The number of bytes between the start of one Pixel and the start of the next (at least 3).
+		@param levels Table of 256 output levels, or nullptr to write colors unchanged.
+		@param residuals The fraction carried over for each channel of each Pixel (number of Pixels * 3 bytes, in RGB order), or nullptr to disable dithering. Only used with levels or in HIGH_PRECISION mode.
+	*/
+	void Section::render_frame(unsigned char* buffer, Colors::ColorOrder order, unsigned int stride, const unsigned short* levels, unsigned char* residuals) {
+		// Determine where each channel goes once rather than per Pixel.
+		unsigned char r_pos = 0, g_pos = 1, b_pos = 2;
+		switch (order) {
+			case Colors::ColorOrder::GRB:
+				r_pos = 1;
+				g_pos = 0;
+				break;
+			case Colors::ColorOrder::BRG:
+				r_pos = 1;
+				g_pos = 2;
+				b_pos = 0;
+				break;
+			default:
+				break;
+		}
+
+		unsigned int num_pixels = dimensions_.size();
+
+		// A mask Canvas blacks out undrawn Pixels, while a color Canvas draws over the finished color.
+		bool color_canvas = (canvas_ != nullptr && canvas_->get_mode() == Canvas::Mode::COLOR);
+		bool mask_canvas = (canvas_ != nullptr && !color_canvas);
+
+		// The low bytes only match the output if nothing blends over the Section's own colors.
+		Colors::RGB* fractions = (residuals != nullptr && !color_canvas) ? fractions_ : nullptr;
+		for (unsigned char index = 0; index < num_layers_ && fractions != nullptr; index++) {
+			if (layers_[index]->visible && layers_[index]->mix_mode != Colors::MixMode::NONE) {
+				fractions = nullptr;
+			}
+		}
+		Colors::RGB fraction = Colors::BLACK;
+
+		// Work through the Section one Canvas word at a time, compositing the layers for the whole run at once.
+		Colors::RGB output[Canvas::WORD_BITS];
+		Colors::RGB layer_buffer[Canvas::WORD_BITS];
+		Colors::RGB color;
+		for (unsigned int start = 0; start < num_pixels; start += Canvas::WORD_BITS) {
+			unsigned int count = num_pixels - start;
+			if (count > Canvas::WORD_BITS) {
+				count = Canvas::WORD_BITS;
+			}
+
+			unsigned long mask = (canvas_ != nullptr) ? canvas_->get_pattern_span(start) : 0;
+
+			// Skip compositing runs that the mask hides completely.
+			Colors::RGB* colors = nullptr;
+			if (!mask_canvas || mask != 0) {
+				colors = composite(start, count, output, layer_buffer);
+			}
+
+			for (unsigned int index = 0; index < count; index++) {
+				if (mask_canvas && (mask & 1) == 0) {
+					color = Colors::BLACK;
+					fraction = Colors::BLACK;
+				}
+				else {
+					color = colors[index];
+					if (fractions != nullptr) {
+						fraction = fractions[start + index];
+					}
+					if (color_canvas && (mask & 1)) {
+						canvas_->blend_pixel(start + index, &color);
+					}
+				}
+
+				if (residuals != nullptr && fractions != nullptr) {
+					// Same as below, but each level includes the channel's low byte.
+					unsigned short level = get_fine_level(levels, color.r, fraction.r) + residuals[0];
+					buffer[r_pos] = level >> 8;
+					residuals[0] = (unsigned char)level;
+					level = get_fine_level(levels, color.g, fraction.g) + residuals[1];
+					buffer[g_pos] = level >> 8;
+					residuals[1] = (unsigned char)level;
+					level = get_fine_level(levels, color.b, fraction.b) + residuals[2];
+					buffer[b_pos] = level >> 8;
+					residuals[2] = (unsigned char)level;
+					residuals += 3;
+				}
+				else if (residuals != nullptr && levels != nullptr) {
+					// Levels top out at 255 << 8, so adding a residual can't overflow.
+					unsigned short level = levels[color.r] + residuals[0];
+					buffer[r_pos] = level >> 8;
+					residuals[0] = (unsigned char)level;
+					level = levels[color.g] + residuals[1];
+					buffer[g_pos] = level >> 8;
+					residuals[1] = (unsigned char)level;
+					level = levels[color.b] + residuals[2];
+					buffer[b_pos] = level >> 8;
+					residuals[2] = (unsigned char)level;
+					residuals += 3;
+				}
+				else if (levels != nullptr) {
+					buffer[r_pos] = levels[color.r] >> 8;
+					buffer[g_pos] = levels[color.g] >> 8;
+					buffer[b_pos] = levels[color.b] >> 8;
+				}
+				else {
+					buffer[r_pos] = color.r;
+					buffer[g_pos] = color.g;
+					buffer[b_pos] = color.b;
+				}
+				buffer += stride;
+				mask >>= 1;
+			}
+		}
 	}
 
 	/**
@@ -191,6 +639,10 @@ namespace PixelMaestro {
 		}
 
 		animation_ = animation;
+
+		// Clear any palette rotation left behind by the previous Animation.
+		set_palette_offset(0);
+
 		return animation_;
 	}
 
@@ -201,13 +653,69 @@ namespace PixelMaestro {
 		@param color New color.
 	*/
 	void Section::set_one(unsigned int pixel, Colors::RGB* color) {
+		// In INDEXED mode, store the color's position in the palette instead.
+		if (storage_mode_ == StorageMode::INDEXED) {
+			set_one_index(pixel, find_palette_index(color));
+			return;
+		}
+
 		// Only continue if Pixel is within the bounds of the array.
 		if (pixel < dimensions_.size()) {
-			/*
-				If pause is enabled, trick the Pixel into thinking the cycle is shorter than it is.
-				This results in the Pixel finishing early and waiting until the next cycle.
-			*/
-			pixels_[pixel].set_next_color(color, animation_->get_fade(), animation_->get_speed() - animation_->get_pause(), *refresh_interval_);
+			// Only trigger an update if the colors don't match.
+			if (next_colors_[pixel] != *color) {
+				unsigned int block = pixel >> BLOCK_SHIFT;
+
+				/*
+					If fading, store the Pixel's current color as the start of the fade.
+					Intermediate colors are calculated from the time since the fade started (see update_fade()).
+					While rendering in bands, update_rows() has already started the fade.
+				*/
+				bool fade;
+				if (rendering_bands_) {
+					fade = band_fade_;
+				}
+				else {
+					fade = (animation_->get_fade() && animation_->get_speed() > animation_->get_pause());
+
+					// The first Pixel to change during an update starts a new fade.
+					if (fade && (num_fading_pixels_ == 0 || fade_start_ != last_update_)) {
+						start_fade();
+					}
+				}
+
+				// A Pixel is fading while its starting and ending colors differ. The total is recounted after rendering in bands.
+				if (previous_colors_[pixel] != next_colors_[pixel] || (previous_fractions_ != nullptr && previous_fractions_[pixel] != Colors::BLACK)) {
+					fading_blocks_[block]--;
+					if (!rendering_bands_) {
+						num_fading_pixels_--;
+					}
+				}
+
+				if (fade) {
+					next_colors_[pixel] = *color;
+					if (start_pixel_fade(pixel)) {
+						fading_blocks_[block]++;
+						if (!rendering_bands_) {
+							num_fading_pixels_++;
+						}
+					}
+				}
+				else {
+					pixels_[pixel] = *color;
+					previous_colors_[pixel] = *color;
+					next_colors_[pixel] = *color;
+					if (fractions_ != nullptr) {
+						fractions_[pixel] = Colors::BLACK;
+						previous_fractions_[pixel] = Colors::BLACK;
+					}
+					pending_blocks_[block] = 1;
+
+					// While rendering in bands, this is set once every band is done.
+					if (!rendering_bands_) {
+						pending_ = true;
+					}
+				}
+			}
 		}
 	}
 
@@ -222,6 +730,36 @@ namespace PixelMaestro {
 		set_one(get_pixel_index(x, y), color);
 	}
 
+	/**
+		Sets the specified Pixel to a palette index (INDEXED mode only).
+		Indices past the end of the palette wrap around to the start. INDEX_OFF turns the Pixel off.
+
+		@param pixel The index of the Pixel to update.
+		@param index New palette index.
+	*/
+	void Section::set_one_index(unsigned int pixel, unsigned char index) {
+		if (indices_ != nullptr && pixel < dimensions_.size() && indices_[pixel] != index) {
+			indices_[pixel] = index;
+			pending_blocks_[pixel >> BLOCK_SHIFT] = 1;
+
+			// While rendering in bands, this is set once every band is done.
+			if (!rendering_bands_) {
+				pending_ = true;
+			}
+		}
+	}
+
+	/**
+		Sets the specified Pixel to a palette index (INDEXED mode only).
+
+		@param x The column number of the Pixel.
+		@param y The row number of the Pixel.
+		@param index New palette index.
+	*/
+	void Section::set_one_index(unsigned short x, unsigned short y, unsigned char index) {
+		set_one_index(get_pixel_index(x, y), index);
+	}
+
 	/**
 		Sets the Pixel array and layout used in the Section.
 
@@ -242,16 +780,77 @@ namespace PixelMaestro {
 
 		// Resize the Pixel grid
 		delete [] pixels_;
-		pixels_ = new Pixel[dimensions_.size()];
+		delete [] next_colors_;
+		delete [] previous_colors_;
+		delete [] fractions_;
+		delete [] previous_fractions_;
+		delete [] indices_;
+		pixels_ = nullptr;
+		next_colors_ = nullptr;
+		previous_colors_ = nullptr;
+		fractions_ = nullptr;
+		previous_fractions_ = nullptr;
+		indices_ = nullptr;
+		if (storage_mode_ == StorageMode::INDEXED) {
+			indices_ = new unsigned char[dimensions_.size()];
+			memset(indices_, INDEX_OFF, dimensions_.size());
+		}
+		else {
+			pixels_ = new Colors::RGB[dimensions_.size()]();
+			next_colors_ = new Colors::RGB[dimensions_.size()]();
+			previous_colors_ = new Colors::RGB[dimensions_.size()]();
+			if (storage_mode_ == StorageMode::HIGH_PRECISION) {
+				fractions_ = new Colors::RGB[dimensions_.size()]();
+				previous_fractions_ = new Colors::RGB[dimensions_.size()]();
+			}
+		}
+		num_fading_pixels_ = 0;
+
+		// Resize the change tracking blocks. Since the layout changed, the entire Section needs to be redrawn.
+		delete [] changed_blocks_;
+		delete [] fading_blocks_;
+		delete [] pending_blocks_;
+		changed_blocks_ = new unsigned char[get_num_blocks()]();
+		fading_blocks_ = new unsigned char[get_num_blocks()]();
+		pending_blocks_ = new unsigned char[get_num_blocks()]();
+		invalidate();
 
 		// Reinitialize the Canvas
 		if (canvas_ != nullptr) {
 			canvas_->initialize_pattern();
 		}
 
-		// Reinitialize the Overlay
-		if (overlay_ != nullptr) {
-			overlay_->section->set_dimensions(dimensions_);
+		// Resize each layer
+		for (unsigned char index = 0; index < num_layers_; index++) {
+			layers_[index]->section->set_dimensions(dimensions_);
+		}
+	}
+
+	/**
+		Sets the Executor used to split updates into bands of rows.
+		The fade pass and Animations that support it (e.g. MandelbrotAnimation) are split into bands, which the Executor runs in parallel.
+		This also applies to each layer.
+
+		@param executor New Executor, or nullptr to update on a single thread.
+	*/
+	void Section::set_executor(Executor* executor) {
+		executor_ = executor;
+		for (unsigned char index = 0; index < num_layers_; index++) {
+			layers_[index]->section->set_executor(executor);
+		}
+	}
+
+	/**
+		Rotates the palette by the specified number of colors (INDEXED mode only).
+		A Pixel with index i displays palette color (i + offset). This changes the color of every Pixel at the cost of updating the palette, rather than each Pixel.
+		If the Animation fades, the palette fades to the new colors.
+
+		@param offset Number of colors to rotate by.
+	*/
+	void Section::set_palette_offset(unsigned char offset) {
+		if (offset != palette_offset_) {
+			palette_offset_ = offset;
+			palette_offset_changed_ = true;
 		}
 	}
 
@@ -264,6 +863,37 @@ namespace PixelMaestro {
 		this->refresh_interval_ = interval;
 	}
 
+	/**
+		Changes how the Section stores Pixel colors.
+		Changing the storage mode clears all Pixels.
+
+		@param mode New storage mode.
+	*/
+	void Section::set_storage_mode(StorageMode mode) {
+		if (mode == storage_mode_) {
+			return;
+		}
+		storage_mode_ = mode;
+
+		delete [] palette_lookup_;
+		delete [] palette_start_;
+		delete [] palette_end_;
+		delete [] palette_source_;
+		palette_lookup_ = nullptr;
+		palette_start_ = nullptr;
+		palette_end_ = nullptr;
+		palette_source_ = nullptr;
+		palette_size_ = 0;
+		palette_fading_ = false;
+
+		// The lookup table has an entry for every index, so resolving a color never needs a bounds check.
+		if (storage_mode_ == StorageMode::INDEXED) {
+			palette_lookup_ = new Colors::RGB[INDEX_OFF + 1]();
+		}
+
+		set_dimensions(dimensions_);
+	}
+
 	/**
 		Main update routine.
 
@@ -271,33 +901,481 @@ namespace PixelMaestro {
 	*/
 	void Section::update(const unsigned long& current_time) {
 
-		// If no animation is set, do nothing.
-		if (animation_ == nullptr) {
+		// If no animation is set, only publish changes made outside of an update.
+		if (animation_ != nullptr) {
+
+			// If this Section has layers or a Canvas, update them first.
+			for (unsigned char index = 0; index < num_layers_; index++) {
+				Overlay* layer = layers_[index];
+				layer->section->update(current_time);
+
+				// Pixels changed in a visible layer also change the output of this Section.
+				if (layer->visible && layer->section->changed_) {
+					unsigned char* layer_blocks = layer->section->changed_blocks_;
+					unsigned int num_blocks = get_num_blocks();
+					for (unsigned int block = 0; block < num_blocks; block++) {
+						pending_blocks_[block] |= layer_blocks[block];
+					}
+					pending_ = true;
+				}
+
+				// The layer's options can be changed directly, so check them here.
+				if (layer->mix_mode != layer->last_mix_mode || layer->alpha != layer->last_alpha || layer->visible != layer->last_visible) {
+					layer->last_mix_mode = layer->mix_mode;
+					layer->last_alpha = layer->alpha;
+					layer->last_visible = layer->visible;
+					invalidate();
+				}
+			}
+			if (canvas_ != nullptr) {
+				if (canvas_->update(current_time)) {
+					invalidate();
+				}
+			}
+
+			/*
+			 * Advance any fade in progress to the current time, then update the animation.
+			 * Doing the fade first means that Pixels changed by the animation start their new fade from an up-to-date color.
+			 * In INDEXED mode, Pixels don't fade individually, so the palette is updated afterwards to pick up any offset the animation just set.
+			 */
+			if (storage_mode_ != StorageMode::INDEXED && num_fading_pixels_ > 0) {
+				update_fade(current_time);
+			}
+			last_update_ = current_time;
+			animation_->update(current_time, this);
+
+			if (storage_mode_ == StorageMode::INDEXED) {
+				update_palette(current_time);
+			}
+		}
+
+		publish_changes();
+	}
+
+	/**
+		Renders every row of the Section using the Animation's update_rows() method.
+		If an Executor is set, the rows are split into bands that render in parallel. Otherwise, all rows render on the calling thread.
+		Animations that support bands call this from their update() method.
+
+		@param animation The Animation to render.
+	*/
+	void Section::update_rows(Animation* animation) {
+		if (dimensions_.size() == 0) {
+			return;
+		}
+
+		unsigned short band_rows = get_band_rows();
+		unsigned int num_bands = (dimensions_.y + band_rows - 1) / band_rows;
+
+		if (executor_ == nullptr || num_bands <= 1) {
+			animation->update_rows(this, 0, dimensions_.y);
 			return;
 		}
 
-		// If this Section has an Overlay or Canvas, update them first.
-		if (overlay_ != nullptr) {
-			overlay_->section->update(current_time);
+		/*
+			set_one() can't safely start a fade or update the total number of fading Pixels from multiple threads.
+			Instead, start the fade here and recount the fading Pixels once every band is done.
+		*/
+		band_fade_ = (animation_->get_fade() && animation_->get_speed() > animation_->get_pause());
+		if (storage_mode_ != StorageMode::INDEXED && band_fade_ && (num_fading_pixels_ == 0 || fade_start_ != last_update_)) {
+			start_fade();
 		}
-		if (canvas_ != nullptr) {
-			canvas_->update(current_time);
+
+		rendering_bands_ = true;
+		RowBandContext context = {this, animation, band_rows};
+		executor_->run(&update_row_band, &context, num_bands);
+		rendering_bands_ = false;
+
+		// The bands may have changed Pixels without fading. publish_changes() checks the blocks to find out.
+		pending_ = true;
+
+		num_fading_pixels_ = 0;
+		unsigned int num_blocks = get_num_blocks();
+		for (unsigned int block = 0; block < num_blocks; block++) {
+			num_fading_pixels_ += fading_blocks_[block];
+		}
+	}
+
+	// Private methods
+
+	/**
+		Returns the position of a color in the Animation's palette.
+		Colors from the palette (e.g. from Animation::get_color_at_index()) are found directly. Black maps to INDEX_OFF, and any other color maps to the closest palette color.
+
+		@param color The color to find.
+		@return The color's palette index.
+	*/
+	unsigned char Section::find_palette_index(Colors::RGB* color) {
+		Colors::RGB* colors = animation_->get_colors();
+		unsigned char num_colors = animation_->get_num_colors();
+		if (colors != nullptr && color >= colors && color < colors + num_colors) {
+			return color - colors;
+		}
+
+		if (*color == Colors::BLACK || num_colors == 0) {
+			return INDEX_OFF;
 		}
 
-		/**
-		 * Update the animation.
-		 * Then, update each Pixel only if the update was successful or if fading is enabled.
-		 */
-		if (animation_->update(current_time, this) || animation_->get_fade()) {
-			for (unsigned short pixel = 0; pixel < dimensions_.size(); pixel++) {
-				pixels_[pixel].update();
+		unsigned char closest = 0;
+		unsigned long closest_distance = (unsigned long)-1;
+		for (unsigned char index = 0; index < num_colors; index++) {
+			long r = colors[index].r - color->r;
+			long g = colors[index].g - color->g;
+			long b = colors[index].b - color->b;
+			unsigned long distance = (r * r) + (g * g) + (b * b);
+			if (distance < closest_distance) {
+				closest = index;
+				closest_distance = distance;
 			}
 		}
+		return closest;
+	}
+
+	/**
+		Finds the next run of flagged blocks, starting at the specified block.
+
+		@param blocks The block flags to search.
+		@param block The block to start searching from. On return, this is the block after the end of the run.
+		@param end_block The block to stop searching at.
+		@param span Stores the Pixels covered by the run.
+		@return True if a run was found.
+	*/
+	bool Section::find_span(unsigned char* blocks, unsigned int& block, unsigned int end_block, Span* span) {
+		while (block < end_block && !blocks[block]) {
+			block++;
+		}
+		if (block >= end_block) {
+			return false;
+		}
+
+		span->start = block << BLOCK_SHIFT;
+		while (block < end_block && blocks[block]) {
+			block++;
+		}
+
+		// The last block might be partially filled.
+		unsigned int end = block << BLOCK_SHIFT;
+		if (end > dimensions_.size()) {
+			end = dimensions_.size();
+		}
+		span->length = end - span->start;
+		return true;
+	}
+
+	/**
+		Returns the number of rows in each band when splitting the Section across an Executor.
+		Bands always start on a block boundary so that no two bands share a block.
+
+		@return Number of rows per band.
+	*/
+	unsigned short Section::get_band_rows() {
+		// Find the smallest number of rows that covers a whole number of blocks.
+		unsigned short aligned_rows = 1;
+		unsigned short lowest_bit = dimensions_.x & -dimensions_.x;
+		if (lowest_bit != 0 && lowest_bit < (1 << BLOCK_SHIFT)) {
+			aligned_rows = (1 << BLOCK_SHIFT) / lowest_bit;
+		}
+
+		// Even a Section without rows needs at least one row per band, otherwise counting the bands divides by zero.
+		unsigned short band_rows = (dimensions_.y + TARGET_BANDS - 1) / TARGET_BANDS;
+		if (band_rows == 0) {
+			band_rows = 1;
+		}
+		return ((band_rows + aligned_rows - 1) / aligned_rows) * aligned_rows;
+	}
+
+	/**
+		Returns the number of blocks used to track changes.
+
+		@return Number of blocks.
+	*/
+	unsigned int Section::get_num_blocks() {
+		return (dimensions_.size() + (1 << BLOCK_SHIFT) - 1) >> BLOCK_SHIFT;
+	}
+
+	/**
+		Returns the current color of a Pixel before applying the Canvas and Overlay.
+
+		@param pixel Index of the Pixel.
+		@return The Pixel's color.
+	*/
+	Colors::RGB Section::get_raw_color(unsigned int pixel) {
+		if (storage_mode_ == StorageMode::INDEXED) {
+			return palette_lookup_[indices_[pixel]];
+		}
+		return pixels_[pixel];
+	}
+
+	/**
+		Returns the colors of a run of Pixels before any post-processing.
+		In DIRECT mode, this points into the Pixel array. In INDEXED mode, the colors are looked up into the buffer.
+
+		@param start Index of the first Pixel.
+		@param count Number of Pixels.
+		@param buffer Array of at least count colors (INDEXED mode only).
+		@return The Pixels' colors.
+	*/
+	Colors::RGB* Section::get_raw_span(unsigned int start, unsigned int count, Colors::RGB* buffer) {
+		if (storage_mode_ == StorageMode::INDEXED) {
+			for (unsigned int pixel = 0; pixel < count; pixel++) {
+				buffer[pixel] = palette_lookup_[indices_[start + pixel]];
+			}
+			return buffer;
+		}
+		return pixels_ + start;
+	}
+
+	/**
+		Publishes the changes made since the last update, then starts tracking a new set of changes.
+	*/
+	void Section::publish_changes() {
+		unsigned int num_blocks = get_num_blocks();
+
+		// If nothing is pending, the only work is clearing the last update's changes (once).
+		if (!pending_) {
+			if (changed_) {
+				memset(changed_blocks_, 0, num_blocks);
+				changed_ = false;
+			}
+			return;
+		}
+
+		unsigned char* published = pending_blocks_;
+		pending_blocks_ = changed_blocks_;
+		changed_blocks_ = published;
+
+		// The old changes only need clearing if there were any.
+		if (changed_) {
+			memset(pending_blocks_, 0, num_blocks);
+		}
+		changed_ = (memchr(changed_blocks_, 1, num_blocks) != nullptr);
+		pending_ = false;
+	}
+
+	/**
+		Starts a new fade at the time of the last update.
+		The fade lasts for the animation's cycle time. If pause is enabled, the fade is shortened by the pause time, so Pixels finish early and wait until the next cycle.
+	*/
+	void Section::start_fade() {
+		/*
+			If the previous fade hasn't finished, restart any Pixels still in motion from their current color.
+			Pixels that happen to be at their next color already are no longer fading.
+		*/
+		if (num_fading_pixels_ > 0) {
+			num_fading_pixels_ = 0;
+			Span span;
+			unsigned int block = 0;
+			while (find_span(fading_blocks_, block, get_num_blocks(), &span)) {
+				memset(&fading_blocks_[span.start >> BLOCK_SHIFT], 0, block - (span.start >> BLOCK_SHIFT));
+				for (unsigned int pixel = span.start; pixel < span.start + span.length; pixel++) {
+					if (start_pixel_fade(pixel)) {
+						fading_blocks_[pixel >> BLOCK_SHIFT]++;
+						num_fading_pixels_++;
+					}
+				}
+			}
+		}
+
+		fade_start_ = last_update_;
+		fade_duration_ = animation_->get_speed() - animation_->get_pause();
+	}
+
+	/**
+		Starts a Pixel's fade from its current color towards its next color.
+
+		@param pixel The index of the Pixel.
+		@return True if the Pixel needs to move, i.e. its current color isn't its next color.
+	*/
+	bool Section::start_pixel_fade(unsigned int pixel) {
+		previous_colors_[pixel] = pixels_[pixel];
+		bool moving = (pixels_[pixel] != next_colors_[pixel]);
+		if (fractions_ != nullptr) {
+			previous_fractions_[pixel] = fractions_[pixel];
+			moving = moving || (fractions_[pixel] != Colors::BLACK);
+		}
+		return moving;
+	}
+
+	/**
+		Recalculates the color of each fading Pixel based on how much of the current fade has elapsed.
+		Since the color is derived from the elapsed time, late or skipped updates don't speed up or slow down the fade.
+		If an Executor is set, the Section is split into bands that update in parallel.
+
+		@param current_time Program runtime.
+	*/
+	void Section::update_fade(const unsigned long& current_time) {
+		unsigned long elapsed = current_time - fade_start_;
+		bool complete = (elapsed >= fade_duration_);
+		unsigned long progress = complete ? 0 : Colors::get_fade_progress(elapsed, fade_duration_);
+
+		unsigned short band_rows = get_band_rows();
+		unsigned int num_bands = (dimensions_.y + band_rows - 1) / band_rows;
+		if (executor_ != nullptr && num_bands > 1) {
+			FadeBandContext context = {this, (unsigned int)((band_rows * dimensions_.x) >> BLOCK_SHIFT), complete, progress};
+			executor_->run(&update_fade_band, &context, num_bands);
+		}
+		else {
+			update_fade_blocks(0, get_num_blocks(), complete, progress);
+		}
+
+		if (complete) {
+			num_fading_pixels_ = 0;
+		}
+
+		// Every fading Pixel changed.
+		pending_ = true;
+	}
+
+	/**
+		Runs one band of the fade pass.
+
+		@param band The index of the band.
+		@param context The FadeBandContext for the current fade.
+	*/
+	void Section::update_fade_band(unsigned int band, void* context) {
+		FadeBandContext* band_context = (FadeBandContext*)context;
+		Section* section = band_context->section;
+
+		unsigned int start_block = band * band_context->band_blocks;
+		unsigned int end_block = start_block + band_context->band_blocks;
+		if (end_block > section->get_num_blocks()) {
+			end_block = section->get_num_blocks();
+		}
+		section->update_fade_blocks(start_block, end_block, band_context->complete, band_context->progress);
+	}
+
+	/**
+		Recalculates the color of each fading Pixel within a range of blocks.
+
+		@param start_block The first block to update.
+		@param end_block The block after the last block to update.
+		@param complete Whether the fade is complete.
+		@param progress How much of the fade has elapsed (see Colors::get_fade_progress()).
+	*/
+	void Section::update_fade_blocks(unsigned int start_block, unsigned int end_block, bool complete, unsigned long progress) {
+		Span span;
+		unsigned int block = start_block;
+		while (find_span(fading_blocks_, block, end_block, &span)) {
+			// Once the fade is complete, jump each Pixel to its next color.
+			if (complete) {
+				for (unsigned int pixel = span.start; pixel < span.start + span.length; pixel++) {
+					pixels_[pixel] = next_colors_[pixel];
+					previous_colors_[pixel] = next_colors_[pixel];
+				}
+				if (fractions_ != nullptr) {
+					for (unsigned int pixel = span.start; pixel < span.start + span.length; pixel++) {
+						fractions_[pixel] = Colors::BLACK;
+						previous_fractions_[pixel] = Colors::BLACK;
+					}
+				}
+			}
+			else if (fractions_ != nullptr) {
+				/*
+					Blend each channel as a 16-bit value using the full 16 bits of progress, keeping the low byte.
+					The largest sum is 65535 * 65536, so this fits in 32 bits.
+				*/
+				unsigned char* start = &previous_colors_[span.start].r;
+				unsigned char* start_fractions = &previous_fractions_[span.start].r;
+				unsigned char* end = &next_colors_[span.start].r;
+				unsigned char* output = &pixels_[span.start].r;
+				unsigned char* output_fractions = &fractions_[span.start].r;
+				unsigned long inverse = 65536 - progress;
+				for (unsigned int channel = 0; channel < span.length * sizeof(Colors::RGB); channel++) {
+					unsigned long level = ((((unsigned long)start[channel] << 8) | start_fractions[channel]) * inverse + ((unsigned long)end[channel] << 8) * progress) >> 16;
+					output[channel] = level >> 8;
+					output_fractions[channel] = level;
+				}
+			}
+			else {
+				Colors::interpolate_span(&previous_colors_[span.start], &next_colors_[span.start], &pixels_[span.start], span.length, progress);
+			}
+
+			// Each fading Pixel changes on every update until the fade completes.
+			for (unsigned int span_block = span.start >> BLOCK_SHIFT; span_block < block; span_block++) {
+				pending_blocks_[span_block] = 1;
+				if (complete) {
+					fading_blocks_[span_block] = 0;
+				}
+			}
+		}
+	}
+
+	/**
+		Checks the Animation's palette for changes, then advances the palette fade (INDEXED mode only).
+		Since every Pixel's color comes from the palette, any change to the palette redraws the entire Section.
+
+		@param current_time Program runtime.
+	*/
+	void Section::update_palette(const unsigned long& current_time) {
+		Colors::RGB* colors = animation_->get_colors();
+		unsigned char num_colors = animation_->get_num_colors();
+		if (colors == nullptr || num_colors == 0) {
+			return;
+		}
+
+		bool changed = palette_offset_changed_ || num_colors != palette_size_ || memcmp(colors, palette_source_, num_colors * sizeof(Colors::RGB)) != 0;
+		if (changed) {
+			if (num_colors != palette_size_) {
+				delete [] palette_start_;
+				delete [] palette_end_;
+				delete [] palette_source_;
+				palette_start_ = new Colors::RGB[num_colors];
+				palette_end_ = new Colors::RGB[num_colors];
+				palette_source_ = new Colors::RGB[num_colors];
+				palette_size_ = num_colors;
+			}
+			palette_offset_changed_ = false;
+
+			// Fade from the colors currently on display to the new palette.
+			for (unsigned char index = 0; index < num_colors; index++) {
+				palette_source_[index] = colors[index];
+				palette_start_[index] = palette_lookup_[index];
+				palette_end_[index] = colors[(index + palette_offset_) % num_colors];
+			}
+
+			palette_fading_ = (animation_->get_fade() && animation_->get_speed() > animation_->get_pause());
+			fade_start_ = current_time;
+			fade_duration_ = animation_->get_speed() - animation_->get_pause();
+		}
+		else if (!palette_fading_) {
+			return;
+		}
+
+		unsigned long elapsed = current_time - fade_start_;
+		if (!palette_fading_ || elapsed >= fade_duration_) {
+			for (unsigned char index = 0; index < palette_size_; index++) {
+				palette_lookup_[index] = palette_end_[index];
+			}
+			palette_fading_ = false;
+		}
+		else {
+			Colors::interpolate_span(palette_start_, palette_end_, palette_lookup_, palette_size_, Colors::get_fade_progress(elapsed, fade_duration_));
+		}
+
+		// Repeat the palette across the rest of the lookup table. INDEX_OFF stays black.
+		for (unsigned short index = palette_size_; index < INDEX_OFF; index++) {
+			palette_lookup_[index] = palette_lookup_[index - palette_size_];
+		}
+		invalidate();
 	}
 
 	Section::~Section() {
 		remove_canvas();
-		remove_overlay();
+		while (num_layers_ > 0) {
+			remove_layer(num_layers_ - 1);
+		}
 		delete [] pixels_;
+		delete [] next_colors_;
+		delete [] previous_colors_;
+		delete [] fractions_;
+		delete [] previous_fractions_;
+		delete [] indices_;
+		delete [] palette_lookup_;
+		delete [] palette_start_;
+		delete [] palette_end_;
+		delete [] palette_source_;
+		delete [] changed_blocks_;
+		delete [] fading_blocks_;
+		delete [] pending_blocks_;
 	}
 }
@@ -8,8 +8,8 @@
 #include "../animation/animation.h"
 #include "../canvas/canvas.h"
 #include "colors.h"
+#include "executor.h"
 #include "point.h"
-#include "pixel.h"
 
 namespace PixelMaestro {
 	class Canvas;
@@ -21,7 +21,8 @@ namespace PixelMaestro {
 		public:
 			/**
 				Overlays a second Section on top of the current one.
-				When getting color output, use get_pixel_color(). This returns RGB values after blending the two Sections together.
+				A Section can stack any number of Overlays (layers). Each one is blended onto the result of the layers below it.
+				When getting color output, use get_pixel_color() or render_frame(). These return RGB values after blending the layers together.
 			*/
 			struct Overlay {
 				/**
@@ -33,9 +34,17 @@ namespace PixelMaestro {
 				/// Method of blending the output from the Overlay with the base Section.
 				Colors::MixMode mix_mode = Colors::MixMode::NONE;
 
-				/// Transparency level of the overlaid Section (if applicable).
+				/// Opacity of the overlaid Section, from 0 (transparent) to 255 (opaque).
 				unsigned char alpha;
 
+				/// Whether the Overlay is drawn. Hidden Overlays still update.
+				bool visible = true;
+
+				/// The mix mode, alpha, and visibility as of the last update. Used by the Section to detect changes to the Overlay's options.
+				Colors::MixMode last_mix_mode = Colors::MixMode::NONE;
+				unsigned char last_alpha = 0;
+				bool last_visible = true;
+
 				/**
 				 * Constructor.
 				 * @param section Section to use as the Overlay.
@@ -53,51 +62,232 @@ namespace PixelMaestro {
 				}
 			};
 
+			/// The ways that a Section can store Pixel colors.
+			enum class StorageMode : unsigned char {
+				/// Each Pixel stores its own color. Supports fading for each Pixel.
+				DIRECT,
+
+				/// Each Pixel stores an index into the Animation's palette. Uses a third of the memory of DIRECT, but fades the palette as a whole.
+				INDEXED,
+
+				/// Like DIRECT, but fades keep 16 bits per channel. When dithering (see Maestro::set_dithering()), the output recovers the steps between 8-bit colors. Uses 6 more bytes per Pixel than DIRECT.
+				HIGH_PRECISION
+			};
+
+			/// In INDEXED mode, the index of a Pixel that is off (black).
+			static const unsigned char INDEX_OFF = 255;
+
+			/// A run of consecutive Pixels.
+			struct Span {
+				/// Index of the first Pixel in the run.
+				unsigned int start;
+
+				/// Number of Pixels in the run.
+				unsigned int length;
+			};
+
+			/// Callback used to iterate over Spans. The context parameter is passed through from the caller.
+			typedef void (*SpanCallback)(unsigned int start, unsigned int length, void* context);
+
 			Section(Point dimensions);
 			Section(unsigned short x, unsigned short y);
 			~Section();
 			Canvas* add_canvas();
-			Section::Overlay* add_overlay(Colors::MixMode mix_mode = Colors::MixMode::ALPHA, unsigned char alpha = 128);
+			Section::Overlay* add_layer(Colors::MixMode mix_mode = Colors::MixMode::ALPHA);
+			Section::Overlay* add_layer(Colors::MixMode mix_mode, unsigned char alpha);
+			Section::Overlay* add_overlay(Colors::MixMode mix_mode = Colors::MixMode::ALPHA);
+			Section::Overlay* add_overlay(Colors::MixMode mix_mode, unsigned char alpha);
+			void for_each_dirty_span(SpanCallback callback, void* context = nullptr);
 			Animation* get_animation();
 			Canvas* get_canvas();
+			bool get_changed();
 			unsigned short get_cycle_interval();
+			static unsigned char get_default_alpha(Colors::MixMode mix_mode);
 			Point* get_dimensions();
+			unsigned int get_dirty_spans(Span* spans, unsigned int max_spans);
+			Executor* get_executor();
+			unsigned char* get_indices();
+			Section::Overlay* get_layer(unsigned char index);
+			unsigned char get_num_layers();
 			Section::Overlay* get_overlay();
-			Pixel* get_pixel(unsigned int pixel);
 			Colors::RGB get_pixel_color(unsigned int pixel);
 			unsigned int get_pixel_index(Point* coordinates);
 			unsigned int get_pixel_index(unsigned short x, unsigned short y);
+			unsigned char get_palette_offset();
+			Colors::RGB* get_pixels();
 			unsigned short get_refresh_interval();
+			StorageMode get_storage_mode();
+			unsigned long get_time_until_change(const unsigned long& current_time);
+			void invalidate();
 			void remove_canvas();
+			void remove_layer(unsigned char index);
 			void remove_overlay();
+			void render_frame(unsigned char* buffer, Colors::ColorOrder order = Colors::ColorOrder::RGB, unsigned int stride = 3, const unsigned short* levels = nullptr, unsigned char* residuals = nullptr);
 			void set_all(Colors::RGB* color);
 			Animation* set_animation(Animation* animation, bool preserve_cycle_index = false);
 			void set_cycle_interval(unsigned short interval, unsigned short pause = 0);
 			void set_dimensions(Point layout);
 			void set_dimensions(unsigned short x, unsigned short y);
+			void set_executor(Executor* executor);
 			void set_one(unsigned int pixel, Colors::RGB* color);
 			void set_one(unsigned short x, unsigned short y, Colors::RGB* color);
+			void set_one_index(unsigned int pixel, unsigned char index);
+			void set_one_index(unsigned short x, unsigned short y, unsigned char index);
+			void set_palette_offset(unsigned char offset);
 			void set_refresh_interval(unsigned short* interval);
+			void set_storage_mode(StorageMode mode);
 			void update(const unsigned long& current_time);
+			void update_rows(Animation* animation);
 
 		private:
+			/// Passes the current fade's state to each band of the fade pass.
+			struct FadeBandContext {
+				Section* section;
+				unsigned int band_blocks;
+				bool complete;
+				unsigned long progress;
+			};
+
 			/// The animation displayed in this Section.
 			Animation* animation_ = nullptr;
 
 			/// The Canvas to display (if applicable).
 			Canvas* canvas_ = nullptr;
 
+			/*
+				Changes to Pixels are tracked in blocks of 16 consecutive Pixels, with one flag per block.
+				Changes accumulate in pending_blocks_ and are published to changed_blocks_ at the end of each update.
+			*/
+
+			/// Whether any Pixels changed during the last update.
+			bool changed_ = false;
+
+			/// Marks the blocks of Pixels that changed during the last update.
+			unsigned char* changed_blocks_ = nullptr;
+
+			/// The number of fading Pixels in each block.
+			unsigned char* fading_blocks_ = nullptr;
+
+			/// Marks the blocks of Pixels that have changed since the last update.
+			unsigned char* pending_blocks_ = nullptr;
+
+			/// Whether any blocks might be marked in pending_blocks_. While false, updates skip the block arrays entirely.
+			bool pending_ = false;
+
 			/// The logical layout of the Pixels.
 			Point dimensions_ = {0, 0};
 
-			/// The Section overlaying the current section (if applicable).
-			Overlay* overlay_ = nullptr;
+			/// Splits the fade pass and row-based Animations into bands of rows. If not set, the Section updates on the calling thread.
+			Executor* executor_ = nullptr;
+
+			/// The Overlays stacked on top of this Section, from bottom to top.
+			Overlay** layers_ = nullptr;
+
+			/// The number of Overlays in the stack.
+			unsigned char num_layers_ = 0;
+
+			/*
+				In INDEXED mode, colors are resolved through a lookup table with one entry for every possible index.
+				Indices past the end of the palette wrap around, and INDEX_OFF is always black.
+				Changes to the palette (or the offset) fade the table from the old colors to the new colors.
+			*/
+
+			/// The palette index of each Pixel (INDEXED mode only).
+			unsigned char* indices_ = nullptr;
+
+			/// Whether the palette is fading.
+			bool palette_fading_ = false;
 
-			/// The array of Pixels managed by the Section.
-			Pixel* pixels_ = nullptr;
+			/// Colors at the end of the current palette fade, after applying the offset.
+			Colors::RGB* palette_end_ = nullptr;
+
+			/// The color of each index (INDEXED mode only).
+			Colors::RGB* palette_lookup_ = nullptr;
+
+			/// Rotates the palette by the specified number of colors.
+			unsigned char palette_offset_ = 0;
+
+			/// Whether the palette offset changed since the last update.
+			bool palette_offset_changed_ = false;
+
+			/// The number of colors in the palette.
+			unsigned char palette_size_ = 0;
+
+			/// A copy of the Animation's palette. Used to detect changes to the palette.
+			Colors::RGB* palette_source_ = nullptr;
+
+			/// Colors at the start of the current palette fade.
+			Colors::RGB* palette_start_ = nullptr;
+
+			/// The method used to store Pixel colors.
+			StorageMode storage_mode_ = StorageMode::DIRECT;
+
+			/*
+				In DIRECT mode, Pixel data is stored as parallel arrays (one entry per Pixel) rather than as an array of Pixel objects.
+				This keeps each plane contiguous so that updates and color retrieval run as linear passes.
+			*/
+
+			/// The current color of each Pixel. Defaults to BLACK.
+			Colors::RGB* pixels_ = nullptr;
+
+			/// The next (i.e. target) color of each Pixel.
+			Colors::RGB* next_colors_ = nullptr;
+
+			/// The color that each Pixel started fading from (only applicable when fading).
+			Colors::RGB* previous_colors_ = nullptr;
+
+			/*
+				In HIGH_PRECISION mode, each channel also has a low byte, so a Pixel's full color is (pixels_ << 8) | fractions_.
+				Layers and color Canvases still blend at 8 bits, so the low bytes only reach the output for Sections without them.
+			*/
+
+			/// The low byte of each channel of each Pixel's current color (HIGH_PRECISION mode only).
+			Colors::RGB* fractions_ = nullptr;
+
+			/// The low byte of each channel of the color that each Pixel started fading from (HIGH_PRECISION mode only).
+			Colors::RGB* previous_fractions_ = nullptr;
+
+			/// The amount of time (in milliseconds) that the current fade lasts.
+			unsigned short fade_duration_ = 0;
+
+			/// The time (in milliseconds) that the current fade started.
+			unsigned long fade_start_ = 0;
+
+			/// The number of Pixels still fading towards their next color. While this is 0, the fade pass is skipped entirely.
+			unsigned int num_fading_pixels_ = 0;
+
+			/*
+				While rendering in bands, set_one() may be called from several threads at once.
+				Each band covers whole blocks, so per-block state is never shared between bands.
+				Anything else that set_one() would normally change is handled before and after the bands run.
+			*/
+
+			/// Whether the Animation is currently rendering in bands.
+			bool rendering_bands_ = false;
+
+			/// Whether Pixels changed while rendering in bands should fade. Cached from the Animation before the bands run.
+			bool band_fade_ = false;
+
+			/// The time of the last update. Used to timestamp color changes.
+			unsigned long last_update_ = 0;
 
 			/// The time between Pixel redraws in milliseconds. Controlled by the Maestro.
 			unsigned short* refresh_interval_ = nullptr;
+
+			unsigned char find_palette_index(Colors::RGB* color);
+			bool find_span(unsigned char* blocks, unsigned int& block, unsigned int end_block, Span* span);
+			Colors::RGB* composite(unsigned int start, unsigned int count, Colors::RGB* output, Colors::RGB* buffer);
+			unsigned short get_band_rows();
+			unsigned int get_num_blocks();
+			Colors::RGB get_raw_color(unsigned int pixel);
+			Colors::RGB* get_raw_span(unsigned int start, unsigned int count, Colors::RGB* buffer);
+			void publish_changes();
+			void start_fade();
+			bool start_pixel_fade(unsigned int pixel);
+			void update_fade(const unsigned long& current_time);
+			static void update_fade_band(unsigned int band, void* context);
+			void update_fade_blocks(unsigned int start_block, unsigned int end_block, bool complete, unsigned long progress);
+			void update_palette(const unsigned long& current_time);
 	};
 }
 
@@ -0,0 +1,121 @@
+#ifdef __STDC_HOSTED__
+
+/*
+	ThreadPool.cpp - Executor that runs tasks on a persistent set of worker threads.
+*/
+
+#include "threadpool.h"
+
+namespace PixelMaestro {
+
+	/**
+		Constructor. Starts the worker threads.
+		The thread calling run() also runs tasks, so the pool starts one less worker than the number of threads.
+
+		@param num_threads Total number of threads to run tasks on. If 0, uses the number of hardware threads.
+	*/
+	ThreadPool::ThreadPool(unsigned int num_threads) : next_task_(0) {
+		if (num_threads == 0) {
+			num_threads = std::thread::hardware_concurrency();
+		}
+
+		for (unsigned int thread = 1; thread < num_threads; thread++) {
+			workers_.push_back(std::thread(&ThreadPool::work, this));
+		}
+	}
+
+	/**
+		Returns the number of threads that run tasks, including the calling thread.
+
+		@return Number of threads.
+	*/
+	unsigned int ThreadPool::get_num_threads() {
+		return workers_.size() + 1;
+	}
+
+	/**
+		Runs a batch of tasks across the worker threads and the calling thread, then waits for the batch to finish.
+		Only one batch can run at a time, so this must not be called from inside a task.
+
+		@param task The task to run.
+		@param context Passed to each task as-is.
+		@param num_tasks Number of times to run the task.
+	*/
+	void ThreadPool::run(Task task, void* context, unsigned int num_tasks) {
+		// Waking the workers isn't worth it for a single task.
+		if (workers_.empty() || num_tasks <= 1) {
+			for (unsigned int index = 0; index < num_tasks; index++) {
+				task(index, context);
+			}
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			task_ = task;
+			context_ = context;
+			num_tasks_ = num_tasks;
+			next_task_.store(0);
+			num_working_ = workers_.size();
+			batch_++;
+		}
+		start_.notify_all();
+
+		run_tasks();
+
+		// Wait for every worker to finish before returning. This acts as the barrier between batches.
+		std::unique_lock<std::mutex> lock(mutex_);
+		done_.wait(lock, [this] { return num_working_ == 0; });
+	}
+
+	// Private methods
+
+	/**
+		Claims and runs tasks from the current batch until none are left.
+		Tasks are claimed one at a time, so threads that finish early pick up the remaining work.
+	*/
+	void ThreadPool::run_tasks() {
+		unsigned int index;
+		while ((index = next_task_.fetch_add(1)) < num_tasks_) {
+			task_(index, context_);
+		}
+	}
+
+	/**
+		Main loop for each worker thread. Waits for a batch, helps run it, then reports back.
+	*/
+	void ThreadPool::work() {
+		unsigned long last_batch = 0;
+		std::unique_lock<std::mutex> lock(mutex_);
+		while (true) {
+			start_.wait(lock, [this, last_batch] { return stopping_ || batch_ != last_batch; });
+			if (stopping_) {
+				return;
+			}
+			last_batch = batch_;
+
+			lock.unlock();
+			run_tasks();
+			lock.lock();
+
+			num_working_--;
+			if (num_working_ == 0) {
+				done_.notify_one();
+			}
+		}
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stopping_ = true;
+		}
+		start_.notify_all();
+
+		for (unsigned int worker = 0; worker < workers_.size(); worker++) {
+			workers_[worker].join();
+		}
+	}
+}
+
+#endif // __STDC_HOSTED__
@@ -0,0 +1,66 @@
+#ifdef __STDC_HOSTED__
+
+/*
+	ThreadPool.h - Executor that runs tasks on a persistent set of worker threads.
+*/
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "executor.h"
+
+namespace PixelMaestro {
+	class ThreadPool : public Executor {
+		public:
+			ThreadPool(unsigned int num_threads = 0);
+			~ThreadPool();
+			unsigned int get_num_threads();
+			void run(Task task, void* context, unsigned int num_tasks);
+
+		private:
+			/// The task currently being run.
+			Task task_ = nullptr;
+
+			/// The context passed to the current task.
+			void* context_ = nullptr;
+
+			/// Incremented for each batch of tasks. Workers use this to detect new batches.
+			unsigned long batch_ = 0;
+
+			/// Signals the calling thread once every worker has finished the current batch.
+			std::condition_variable done_;
+
+			/// Guards the batch state and condition variables.
+			std::mutex mutex_;
+
+			/// The index of the next unclaimed task in the current batch.
+			std::atomic<unsigned int> next_task_;
+
+			/// The number of tasks in the current batch.
+			unsigned int num_tasks_ = 0;
+
+			/// The number of workers that haven't finished the current batch.
+			unsigned int num_working_ = 0;
+
+			/// Signals the workers that a new batch is available (or that the pool is shutting down).
+			std::condition_variable start_;
+
+			/// Whether the pool is shutting down.
+			bool stopping_ = false;
+
+			/// The worker threads.
+			std::vector<std::thread> workers_;
+
+			void run_tasks();
+			void work();
+	};
+}
+
+#endif // THREADPOOL_H
+
+#endif // __STDC_HOSTED__
@@ -0,0 +1,26 @@
+#include "canvasdrawellipseevent.h"
+
+namespace PixelMaestro {
+	/**
+	 * Constructor. Draws an ellipse on a Canvas.
+	 * @param time Time until the Event runs.
+	 * @param canvas Canvas to draw on.
+	 * @param origin_x Center x coordinate.
+	 * @param origin_y Center y coordinate.
+	 * @param radius_x The size of the ellipse along the x-axis.
+	 * @param radius_y The size of the ellipse along the y-axis.
+	 * @param fill Whether or not to fill the ellipse.
+	 */
+	CanvasDrawEllipseEvent::CanvasDrawEllipseEvent(unsigned long time, Canvas* canvas, unsigned short origin_x, unsigned short origin_y, unsigned short radius_x, unsigned short radius_y, bool fill) : Event(time) {
+		this->canvas_ = canvas;
+		this->origin_x_ = origin_x;
+		this->origin_y_ = origin_y;
+		this->radius_x_ = radius_x;
+		this->radius_y_ = radius_y;
+		this->fill_ = fill;
+	}
+
+	void CanvasDrawEllipseEvent::run() {
+		canvas_->draw_ellipse(origin_x_, origin_y_, radius_x_, radius_y_, fill_);
+	}
+}
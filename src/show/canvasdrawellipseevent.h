@@ -0,0 +1,22 @@
+#ifndef CANVASDRAWELLIPSEEVENT_H
+#define CANVASDRAWELLIPSEEVENT_H
+
+#include "../canvas/canvas.h"
+#include "../core/point.h"
+#include "event.h"
+
+namespace PixelMaestro {
+	class CanvasDrawEllipseEvent : public Event {
+		public:
+			CanvasDrawEllipseEvent(unsigned long time, Canvas* canvas, unsigned short origin_x, unsigned short origin_y, unsigned short radius_x, unsigned short radius_y, bool fill);
+			void run();
+
+		private:
+			Canvas* canvas_;
+			bool fill_;
+			unsigned short origin_x_, origin_y_;
+			unsigned short radius_x_, radius_y_;
+	};
+}
+
+#endif // CANVASDRAWELLIPSEEVENT_H
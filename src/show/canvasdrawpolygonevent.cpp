@@ -0,0 +1,23 @@
+#include "canvasdrawpolygonevent.h"
+
+namespace PixelMaestro {
+	/**
+	 * Constructor. Draws a polygon on a Canvas.
+	 * The points aren't copied, so they must still exist when the Event runs.
+	 * @param time Time until the Event runs.
+	 * @param canvas Canvas to draw on.
+	 * @param points The polygon's corners.
+	 * @param num_points The number of corners.
+	 * @param fill Whether to fill the polygon.
+	 */
+	CanvasDrawPolygonEvent::CanvasDrawPolygonEvent(unsigned long time, Canvas* canvas, Point* points, unsigned short num_points, bool fill) : Event(time) {
+		this->canvas_ = canvas;
+		this->points_ = points;
+		this->num_points_ = num_points;
+		this->fill_ = fill;
+	}
+
+	void CanvasDrawPolygonEvent::run() {
+		canvas_->draw_polygon(points_, num_points_, fill_);
+	}
+}
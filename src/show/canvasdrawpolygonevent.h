@@ -0,0 +1,22 @@
+#ifndef CANVASDRAWPOLYGONEVENT_H
+#define CANVASDRAWPOLYGONEVENT_H
+
+#include "../canvas/canvas.h"
+#include "../core/point.h"
+#include "event.h"
+
+namespace PixelMaestro {
+	class CanvasDrawPolygonEvent : public Event {
+		public:
+			CanvasDrawPolygonEvent(unsigned long time, Canvas* canvas, Point* points, unsigned short num_points, bool fill);
+			void run();
+
+		private:
+			Canvas* canvas_;
+			bool fill_;
+			unsigned short num_points_;
+			Point* points_;
+	};
+}
+
+#endif // CANVASDRAWPOLYGONEVENT_H
@@ -0,0 +1,15 @@
+#include "sectionaddlayerevent.h"
+
+namespace PixelMaestro {
+	SectionAddLayerEvent::SectionAddLayerEvent(unsigned long time, Section* section, Colors::MixMode mix_mode) : SectionAddLayerEvent(time, section, mix_mode, Section::get_default_alpha(mix_mode)) { }
+
+	SectionAddLayerEvent::SectionAddLayerEvent(unsigned long time, Section* section, Colors::MixMode mix_mode, unsigned char alpha) : Event(time) {
+		this->section_ = section;
+		this->mix_mode_ = mix_mode;
+		this->alpha_ = alpha;
+	}
+
+	void SectionAddLayerEvent::run() {
+		section_->add_layer(mix_mode_, alpha_);
+	}
+}
@@ -0,0 +1,22 @@
+#ifndef SECTIONADDLAYEREVENT_H
+#define SECTIONADDLAYEREVENT_H
+
+#include "../core/colors.h"
+#include "../core/section.h"
+#include "event.h"
+
+namespace PixelMaestro {
+	class SectionAddLayerEvent : public Event {
+		public:
+			SectionAddLayerEvent(unsigned long time, Section* section, Colors::MixMode mix_mode = Colors::MixMode::ALPHA);
+			SectionAddLayerEvent(unsigned long time, Section* section, Colors::MixMode mix_mode, unsigned char alpha);
+			void run();
+
+		private:
+			unsigned char alpha_;
+			Colors::MixMode mix_mode_;
+			Section* section_;
+	};
+}
+
+#endif // SECTIONADDLAYEREVENT_H
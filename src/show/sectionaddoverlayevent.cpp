@@ -1,6 +1,8 @@
 #include "sectionaddoverlayevent.h"
 
 namespace PixelMaestro {
+	SectionAddOverlayEvent::SectionAddOverlayEvent(unsigned long time, Section* section, Colors::MixMode mix_mode) : SectionAddOverlayEvent(time, section, mix_mode, Section::get_default_alpha(mix_mode)) { }
+
 	SectionAddOverlayEvent::SectionAddOverlayEvent(unsigned long time, Section* section, Colors::MixMode mix_mode, unsigned char alpha) : Event(time) {
 		this->section_ = section;
 		this->mix_mode_ = mix_mode;
@@ -8,7 +8,8 @@
 namespace PixelMaestro {
 	class SectionAddOverlayEvent : public Event {
 		public:
-			SectionAddOverlayEvent(unsigned long time, Section* section, Colors::MixMode mix_mode = Colors::MixMode::ALPHA, unsigned char alpha = 128);
+			SectionAddOverlayEvent(unsigned long time, Section* section, Colors::MixMode mix_mode = Colors::MixMode::ALPHA);
+			SectionAddOverlayEvent(unsigned long time, Section* section, Colors::MixMode mix_mode, unsigned char alpha);
 			void run();
 
 		private:
@@ -0,0 +1,12 @@
+#include "sectionremovelayerevent.h"
+
+namespace PixelMaestro {
+	SectionRemoveLayerEvent::SectionRemoveLayerEvent(unsigned long time, Section* section, unsigned char index) : Event(time) {
+		this->section_ = section;
+		this->index_ = index;
+	}
+
+	void SectionRemoveLayerEvent::run() {
+		section_->remove_layer(index_);
+	}
+}
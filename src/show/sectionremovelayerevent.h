@@ -0,0 +1,19 @@
+#ifndef SECTIONREMOVELAYEREVENT_H
+#define SECTIONREMOVELAYEREVENT_H
+
+#include "../core/section.h"
+#include "event.h"
+
+namespace PixelMaestro {
+	class SectionRemoveLayerEvent : public Event {
+		public:
+			SectionRemoveLayerEvent(unsigned long time, Section* section, unsigned char index);
+			void run();
+
+		private:
+			unsigned char index_;
+			Section* section_;
+	};
+}
+
+#endif // SECTIONREMOVELAYEREVENT_H
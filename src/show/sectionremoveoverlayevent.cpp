@@ -6,6 +6,6 @@ namespace PixelMaestro {
 	}
 
 	void SectionRemoveOverlayEvent::run() {
-		section_->remove_canvas();
+		section_->remove_overlay();
 	}
 }
@@ -2,6 +2,7 @@
 	Show.cpp - Library for scheduling PixelMaestro animations.
 */
 
+#include "../utility.h"
 #include "show.h"
 
 namespace PixelMaestro {
@@ -32,6 +33,24 @@ namespace PixelMaestro {
 		return timing_;
 	}
 
+	/**
+	 * Returns the time until the next Event runs.
+	 * @param current_time Program runtime.
+	 * @return Time until the next Event (in ms), 0 if the Event is due, or the longest possible time if the Show has finished.
+	 */
+	unsigned long Show::get_time_until_event(const unsigned long& current_time) {
+		if (num_events_ == 0 || (!loop_ && current_index_ == num_events_)) {
+			return (unsigned long)-1;
+		}
+
+		// Uses the same timing as check_next_event().
+		unsigned long time = events_[current_index_]->get_time();
+		if (timing_ == TimingModes::ABSOLUTE) {
+			return (current_time >= time) ? 0 : time - current_time;
+		}
+		return Utility::time_remaining(last_time_, time, current_time);
+	}
+
 	/**
 		Sets the Events in the Show.
 
@@ -67,10 +86,7 @@ namespace PixelMaestro {
 		@param current_time Program runtime.
 	*/
 	void Show::update(const unsigned long& current_time) {		
-		// Only run if we're looping, or if we haven't reached the end of the Event list yet.
-		if (loop_ || (!loop_ && current_index_ != num_events_)) {
-			check_next_event(current_time);
-		}
+		check_next_event(current_time);
 	}
 
 	// Private methods
@@ -79,6 +95,11 @@ namespace PixelMaestro {
 	 * Checks the next Event's start time, then runs it if it's ready.
 	 */
 	void Show::check_next_event(const unsigned long& current_time) {
+		// Only run if we're looping, or if we haven't reached the end of the Event list yet.
+		if (num_events_ == 0 || (!loop_ && current_index_ == num_events_)) {
+			return;
+		}
+
 		/*
 			Based on the timing method used, determine whether to run the Event.
 			If ABSOLUTE, compare the current time to the next Event's start time.
@@ -25,6 +25,7 @@ namespace PixelMaestro {
 			Show(Event **events, unsigned short num_events);
 			bool get_looping();
 			TimingModes get_timing();
+			unsigned long get_time_until_event(const unsigned long& current_time);
 			void set_events(Event **events, unsigned short num_events);
 			void set_timing(TimingModes timing);
 			void set_looping(bool loop);
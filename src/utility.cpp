@@ -5,6 +5,14 @@ namespace PixelMaestro {
 	// Must initialize static char value in source file.
 	int Utility::seed_ = 1;
 
+	const unsigned char Utility::SINE_TABLE[] = {
+		128, 131, 134, 137, 140, 144, 147, 150, 153, 156, 159, 162, 165, 168, 171, 174,
+		177, 179, 182, 185, 188, 191, 193, 196, 199, 201, 204, 206, 209, 211, 213, 216,
+		218, 220, 222, 224, 226, 228, 230, 232, 234, 235, 237, 239, 240, 241, 243, 244,
+		245, 246, 248, 249, 250, 250, 251, 252, 253, 253, 254, 254, 254, 255, 255, 255,
+		255
+	};
+
 	/**
 	 * Returns the absolute value of an integer.
 	 * @param val The integer to evaluate.
@@ -29,6 +37,27 @@ namespace PixelMaestro {
 		}
 	}
 
+	/**
+	 * Returns the sine of an angle using integer math.
+	 * The angle is measured in 256ths of a full turn, and the result is scaled from 0 (-1) to 255 (1).
+	 * @param theta Angle (0 - 255).
+	 * @return The sine of the angle (0 - 255).
+	 */
+	unsigned char Utility::sin8(unsigned char theta) {
+		if (theta < 64) {
+			return SINE_TABLE[theta];
+		}
+		else if (theta < 128) {
+			return SINE_TABLE[128 - theta];
+		}
+		else if (theta < 192) {
+			return 255 - SINE_TABLE[theta - 128];
+		}
+		else {
+			return 255 - SINE_TABLE[256 - theta];
+		}
+	}
+
 	/**
 	 * Returns the square root of a number.
 	 * @param val Number to evaluate.
@@ -60,4 +89,17 @@ namespace PixelMaestro {
 	unsigned int Utility::square(short val) {
 		return val * val;
 	}
+
+	/**
+	 * Returns the time left in an interval.
+	 * This uses the same elapsed time check as the update methods, so it stays correct when the runtime wraps around.
+	 * @param start The time that the interval started.
+	 * @param interval The length of the interval.
+	 * @param current_time The program's current runtime.
+	 * @return The time left, or 0 if the interval has passed.
+	 */
+	unsigned long Utility::time_remaining(unsigned long start, unsigned long interval, const unsigned long& current_time) {
+		unsigned long elapsed = current_time - start;
+		return (elapsed >= interval) ? 0 : interval - elapsed;
+	}
 }
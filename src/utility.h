@@ -6,10 +6,15 @@ namespace PixelMaestro {
 		public:
 			static unsigned int abs_int(short val);
 			static int rand(int max = 0);
+			static unsigned char sin8(unsigned char theta);
 			static float sqrt(float val);
 			static unsigned int square(short val);
+			static unsigned long time_remaining(unsigned long start, unsigned long interval, const unsigned long& current_time);
 
 		private:
+			/// The first quarter of a sine wave, used by sin8().
+			static const unsigned char SINE_TABLE[65];
+
 			/// Initial RNG seed.
 			static int seed_;
 	};
@@ -0,0 +1,191 @@
+#include "../catch/single_include/catch.hpp"
+#include "canvas/canvas.h"
+#include "canvastest.h"
+#include "section.h"
+
+using namespace PixelMaestro;
+
+TEST_CASE("Store the Canvas pattern as bits.", "[Canvas]") {
+	Section section(70, 3);
+	Canvas* canvas = section.add_canvas();
+
+	SECTION("Verify that rectangles fill across words.") {
+		canvas->draw_rect(5, 1, 60, 2, true);
+		REQUIRE(canvas->get_num_drawn() == 120);
+		REQUIRE_FALSE(canvas->get_pattern_index(section.get_pixel_index(4, 1)));
+		REQUIRE(canvas->get_pattern_index(section.get_pixel_index(64, 2)));
+		REQUIRE_FALSE(canvas->get_pattern_index(section.get_pixel_index(65, 2)));
+	}
+
+	SECTION("Verify that spans match individual Pixels.") {
+		canvas->draw_rect(0, 0, 70, 3, false);
+		canvas->draw_point(35, 1);
+		for (unsigned int start = 0; start < section.get_dimensions()->size(); start += 13) {
+			unsigned long span = canvas->get_pattern_span(start);
+			for (unsigned char bit = 0; bit < Canvas::WORD_BITS && start + bit < section.get_dimensions()->size(); bit++) {
+				REQUIRE(((span >> bit) & 1) == canvas->get_pattern_index(start + bit));
+			}
+		}
+	}
+
+	SECTION("Verify that clearing and erasing remove Pixels.") {
+		canvas->fill();
+		REQUIRE(canvas->get_num_drawn() == 210);
+		canvas->erase(10, 1);
+		REQUIRE(canvas->get_num_drawn() == 209);
+		canvas->clear();
+		REQUIRE(canvas->get_num_drawn() == 0);
+	}
+}
+
+TEST_CASE("Offset and scroll the Canvas.", "[Canvas]") {
+	Section section(10, 2);
+	Canvas* canvas = section.add_canvas();
+	canvas->draw_point(8, 0);
+
+	SECTION("Verify that the offset moves the pattern.") {
+		canvas->set_offset(1, 1);
+		REQUIRE(canvas->get_pattern_index(section.get_pixel_index(9, 1)));
+		REQUIRE_FALSE(canvas->get_pattern_index(section.get_pixel_index(8, 0)));
+		REQUIRE((canvas->get_pattern_span(0) >> section.get_pixel_index(9, 1)) & 1);
+
+		// Without repeating, the pattern doesn't wrap around.
+		canvas->set_offset(3, 0);
+		REQUIRE(canvas->get_num_drawn() == 1);
+		REQUIRE(canvas->get_pattern_span(0) == 0);
+	}
+
+	SECTION("Verify that repeated scrolling wraps around.") {
+		canvas->set_scroll(1, 0, true, 128);
+		canvas->set_offset(3, 0);
+		REQUIRE(canvas->get_pattern_index(section.get_pixel_index(1, 0)));
+
+		// Half a Pixel per update.
+		canvas->update(1);
+		REQUIRE(canvas->get_pattern_index(section.get_pixel_index(1, 0)));
+		canvas->update(2);
+		REQUIRE(canvas->get_pattern_index(section.get_pixel_index(2, 0)));
+	}
+}
+
+TEST_CASE("Draw on a Canvas larger than the Section.", "[Canvas]") {
+	Section section(10, 4);
+	Canvas* canvas = section.add_canvas();
+	canvas->set_size(200, 4);
+	canvas->draw_point(0, 3);
+	canvas->draw_point(150, 3);
+
+	SECTION("Verify that drawing is clipped to the Canvas.") {
+		canvas->draw_point(200, 3);
+		REQUIRE(canvas->get_size()->x == 200);
+		REQUIRE(canvas->get_num_drawn() == 2);
+	}
+
+	SECTION("Verify that the offset moves the Section across the Canvas.") {
+		canvas->set_offset(-145, 0);
+		REQUIRE(canvas->get_pattern_index(section.get_pixel_index(5, 3)));
+		REQUIRE_FALSE(canvas->get_pattern_index(section.get_pixel_index(0, 3)));
+	}
+
+	SECTION("Verify that the Canvas scrolls off of the Section before wrapping around.") {
+		canvas->set_scroll(-1, 0, false);
+		canvas->set_offset(-199, 0);
+		canvas->update(1);
+		for (unsigned int pixel = 0; pixel < section.get_dimensions()->size(); pixel++) {
+			REQUIRE_FALSE(canvas->get_pattern_index(pixel));
+		}
+
+		canvas->update(2);
+		REQUIRE(canvas->get_pattern_index(section.get_pixel_index(9, 3)));
+	}
+}
+
+TEST_CASE("Draw shapes on the Canvas.", "[Canvas]") {
+	Section section(20, 12);
+	Canvas* canvas = section.add_canvas();
+
+	SECTION("Verify that lines include both end points.") {
+		canvas->draw_line(9, 3, 0, 0);
+		REQUIRE(canvas->get_num_drawn() == 10);
+		REQUIRE(canvas->get_pattern_index(section.get_pixel_index(0, 0)));
+		REQUIRE(canvas->get_pattern_index(section.get_pixel_index(9, 3)));
+	}
+
+	SECTION("Verify that circles are filled and clipped.") {
+		canvas->draw_circle(5, 5, 2, true);
+		REQUIRE(canvas->get_num_drawn() == 21);
+		REQUIRE_FALSE(canvas->get_pattern_index(section.get_pixel_index(7, 7)));
+
+		canvas->clear();
+		canvas->draw_circle(0, 0, 3, false);
+		REQUIRE(canvas->get_num_drawn() == 5);
+	}
+
+	SECTION("Verify that ellipses reach both radii.") {
+		canvas->draw_ellipse(10, 5, 6, 2, false);
+		REQUIRE(canvas->get_pattern_index(section.get_pixel_index(4, 5)));
+		REQUIRE(canvas->get_pattern_index(section.get_pixel_index(16, 5)));
+		REQUIRE(canvas->get_pattern_index(section.get_pixel_index(10, 3)));
+		REQUIRE(canvas->get_pattern_index(section.get_pixel_index(10, 7)));
+		REQUIRE_FALSE(canvas->get_pattern_index(section.get_pixel_index(10, 5)));
+	}
+
+	SECTION("Verify that polygons are filled using the even-odd rule.") {
+		Point star[] = {{10, 0}, {13, 11}, {1, 4}, {19, 4}, {7, 11}};
+		canvas->draw_polygon(star, 5, true);
+		REQUIRE(canvas->get_pattern_index(section.get_pixel_index(10, 2)));
+		REQUIRE_FALSE(canvas->get_pattern_index(section.get_pixel_index(10, 6)));
+	}
+}
+
+TEST_CASE("Draw large shapes on the Canvas.", "[Canvas]") {
+	Section section(10, 10);
+	Canvas* canvas = section.add_canvas();
+	canvas->set_size(2600, 2600);
+
+	SECTION("Verify that large ellipses are filled without overflowing.") {
+		// The area of an ellipse is pi * radius_x * radius_y.
+		canvas->draw_ellipse(1300, 1300, 1250, 1200, true);
+		double area = 3.14159265 * 1250 * 1200;
+		REQUIRE(canvas->get_num_drawn() > area * 0.999);
+		REQUIRE(canvas->get_num_drawn() < area * 1.001);
+	}
+
+	SECTION("Verify that large polygons are filled without overflowing.") {
+		Point triangle[] = {{0, 0}, {2599, 2599}, {0, 2599}};
+		canvas->draw_polygon(triangle, 3, true);
+		REQUIRE(canvas->get_num_drawn() == (2600 * 2601) / 2);
+	}
+}
+
+TEST_CASE("Draw in color on the Canvas.", "[Canvas]") {
+	Section section(10, 4);
+	Canvas* canvas = section.add_canvas();
+	canvas->set_mode(Canvas::Mode::COLOR);
+	canvas->set_drawing_color(&Colors::RED);
+	canvas->draw_point(1, 1);
+	canvas->set_drawing_color(&Colors::BLUE, 128);
+	canvas->draw_rect(4, 0, 2, 2, true);
+
+	SECTION("Verify that Pixels keep the color they were drawn in.") {
+		REQUIRE(canvas->get_pattern_color(section.get_pixel_index(1, 1))->color == Colors::RED);
+		REQUIRE(canvas->get_pattern_color(section.get_pixel_index(5, 1))->alpha == 128);
+		REQUIRE(canvas->get_pattern_color(section.get_pixel_index(2, 1)) == nullptr);
+	}
+
+	SECTION("Verify that drawn Pixels are blended over the Animation.") {
+		Colors::RGB color = Colors::WHITE;
+		canvas->blend_pixel(section.get_pixel_index(1, 1), &color);
+		REQUIRE(color == Colors::RED);
+
+		color = Colors::BLACK;
+		canvas->blend_pixel(section.get_pixel_index(4, 0), &color);
+		REQUIRE(color.r == 0);
+		REQUIRE(color.b == 127);
+
+		// Undrawn Pixels leave the Animation alone.
+		color = Colors::WHITE;
+		canvas->blend_pixel(section.get_pixel_index(8, 3), &color);
+		REQUIRE(color == Colors::WHITE);
+	}
+}
@@ -0,0 +1,14 @@
+#ifndef CANVASTEST_H
+#define CANVASTEST_H
+
+class CanvasTest
+{
+    public:
+        CanvasTest();
+
+    protected:
+
+    private:
+};
+
+#endif // CANVASTEST_H
@@ -69,11 +69,11 @@ TEST_CASE("Can generate scaling color array.", "[Array]") {
 
 TEST_CASE("Can mix colors.", "[Colors::RGB]") {
 
-    SECTION("Normal blending red and blue results in purple.") {
-        Colors::RGB purple = Colors::mix_colors(&Colors::RED, &Colors::BLUE, Colors::MixMode::NORMAL, 0.5);
+    SECTION("Alpha blending red and blue results in purple.") {
+        Colors::RGB purple = Colors::mix_colors(&Colors::RED, &Colors::BLUE, Colors::MixMode::ALPHA, 128);
         REQUIRE(purple.r == 127);
         REQUIRE(purple.g == 0);
-        REQUIRE(purple.b == 127);
+        REQUIRE(purple.b == 128);
     }
 
     SECTION("Color multiplied by half equals halved values.") {
@@ -88,8 +88,96 @@ TEST_CASE("Can mix colors.", "[Colors::RGB]") {
 	}
 	
 	SECTION("Colors blend with specified alpha.") {
-		Colors::RGB mixed = Colors::mix_colors(&Colors::BLACK, &Colors::WHITE, Colors::MixMode::ALPHA_BLENDING, 0.2);
+		Colors::RGB mixed = Colors::mix_colors(&Colors::BLACK, &Colors::WHITE, Colors::MixMode::ALPHA, 51);
 		Colors::RGB target = {51, 51, 51};
 		REQUIRE(mixed == target);
 	}
 }
+
+TEST_CASE("Can mix arrays of colors.", "[Array]") {
+	const unsigned int num_colors = 20;
+	Colors::RGB base[num_colors];
+	Colors::RGB overlay[num_colors];
+	Colors::RGB output[num_colors];
+	for (unsigned int index = 0; index < num_colors; index++) {
+		base[index] = {200, 100, 20};
+		overlay[index] = {100, 150, 40};
+	}
+
+	SECTION("Each mix mode is applied to every color.") {
+		Colors::MixMode modes[] = {Colors::MixMode::MULTIPLY, Colors::MixMode::ADD, Colors::MixMode::SCREEN, Colors::MixMode::LIGHTEN, Colors::MixMode::DIFFERENCE};
+		Colors::RGB targets[] = {{78, 59, 3}, {255, 250, 60}, {222, 191, 57}, {200, 150, 40}, {100, 50, 20}};
+		for (unsigned char mode = 0; mode < 5; mode++) {
+			Colors::mix_span(base, overlay, output, num_colors, modes[mode], 255);
+			for (unsigned int index = 0; index < num_colors; index++) {
+				REQUIRE(output[index] == targets[mode]);
+			}
+		}
+	}
+
+	SECTION("Alpha sets the opacity of the overlay.") {
+		Colors::mix_span(base, overlay, base, num_colors, Colors::MixMode::DIFFERENCE, 128);
+		Colors::RGB target = {150, 75, 20};
+		for (unsigned int index = 0; index < num_colors; index++) {
+			REQUIRE(base[index] == target);
+		}
+	}
+
+	SECTION("Mixing a single color matches mixing a span.") {
+		Colors::RGB mixed = Colors::mix_colors(&base[0], &overlay[0], Colors::MixMode::SCREEN, 77);
+		Colors::mix_span(base, overlay, output, num_colors, Colors::MixMode::SCREEN, 77);
+		REQUIRE(mixed == output[num_colors - 1]);
+	}
+}
+
+TEST_CASE("Color math saturates.", "[Colors::RGB]") {
+	Colors::RGB bright = {250, 10, 128};
+	Colors::RGB dim = {10, 20, 128};
+
+	SECTION("Adding and subtracting stops at 255 and 0.") {
+		Colors::RGB sum = {255, 30, 255};
+		Colors::RGB difference = {240, 0, 0};
+		REQUIRE(bright + dim == sum);
+		REQUIRE(bright - dim == difference);
+		REQUIRE(Colors::add(&bright, &dim) == sum);
+		REQUIRE(Colors::subtract(&bright, &dim) == difference);
+	}
+
+	SECTION("Scaling and lerping use integer math.") {
+		Colors::RGB half = {125, 5, 64};
+		REQUIRE(Colors::scale(&bright, 127) == half);
+		REQUIRE(Colors::scale(&bright, 255) == bright);
+		REQUIRE(Colors::lerp(&bright, &dim, 0) == bright);
+		REQUIRE(Colors::lerp(&bright, &dim, 255) == dim);
+	}
+
+	SECTION("Array forms match the single color forms.") {
+		Colors::RGB colors_one[20];
+		Colors::RGB colors_two[20];
+		Colors::RGB output[20];
+		for (unsigned char index = 0; index < 20; index++) {
+			colors_one[index] = {(unsigned char)(index * 13), (unsigned char)(255 - index), 200};
+			colors_two[index] = {(unsigned char)(index * 7), 100, (unsigned char)(index * 11)};
+		}
+
+		Colors::add_span(colors_one, colors_two, output, 20);
+		for (unsigned char index = 0; index < 20; index++) {
+			REQUIRE(output[index] == Colors::add(&colors_one[index], &colors_two[index]));
+		}
+
+		Colors::subtract_span(colors_one, colors_two, output, 20);
+		for (unsigned char index = 0; index < 20; index++) {
+			REQUIRE(output[index] == Colors::subtract(&colors_one[index], &colors_two[index]));
+		}
+
+		Colors::scale_span(colors_one, output, 20, 90);
+		for (unsigned char index = 0; index < 20; index++) {
+			REQUIRE(output[index] == Colors::scale(&colors_one[index], 90));
+		}
+
+		Colors::lerp_span(colors_one, colors_two, output, 20, 90);
+		for (unsigned char index = 0; index < 20; index++) {
+			REQUIRE(output[index] == Colors::lerp(&colors_one[index], &colors_two[index], 90));
+		}
+	}
+}
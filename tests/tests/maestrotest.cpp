@@ -1,5 +1,281 @@
+#include <string.h>
 #include "../catch/single_include/catch.hpp"
+#include "animation/solidanimation.h"
+#include "animation/waveanimation.h"
+#include "show/animationsetfadeevent.h"
+#include "gamma.h"
 #include "maestro.h"
+#include "threadpool.h"
 
 using namespace PixelMaestro;
 
+/// A Maestro with up to three Sections of the same size, each running its own WaveAnimation.
+struct WaveMaestro {
+	Section sections[3];
+	WaveAnimation animations[3];
+	Maestro maestro;
+
+	WaveMaestro(unsigned char num_sections, unsigned short x, unsigned short y, unsigned short speed = 100, bool fade = true) :
+		sections{Section(x, y), Section(x, y), Section(x, y)},
+		animations{
+			WaveAnimation(Colors::COLORWHEEL, 12, speed),
+			WaveAnimation(Colors::COLORWHEEL, 12, speed),
+			WaveAnimation(Colors::COLORWHEEL, 12, speed)
+		},
+		maestro(sections, num_sections) {
+		for (unsigned char section = 0; section < 3; section++) {
+			animations[section].set_fade(fade);
+			sections[section].set_animation(&animations[section]);
+		}
+	}
+};
+
+TEST_CASE("Update Sections in parallel.", "[Maestro]") {
+	WaveMaestro serial_fixture(3, 8, 4);
+	WaveMaestro parallel_fixture(3, 8, 4);
+	Maestro& serial = serial_fixture.maestro;
+	Maestro& parallel = parallel_fixture.maestro;
+	ThreadPool pool(4);
+	parallel.set_executor(&pool);
+
+	// Both Maestros should produce the same frames.
+	unsigned char serial_frame[3 * 32 * 3];
+	unsigned char parallel_frame[3 * 32 * 3];
+	for (unsigned long time = 0; time <= 1000; time += 20) {
+		serial.update(time);
+		parallel.update(time);
+		serial.render_frame(serial_frame);
+		parallel.render_frame(parallel_frame);
+		REQUIRE(memcmp(serial_frame, parallel_frame, sizeof(serial_frame)) == 0);
+	}
+}
+
+TEST_CASE("Publish frames through the frame buffer.", "[Maestro]") {
+	WaveMaestro fixture(1, 8, 4);
+	Section* sections = fixture.sections;
+	Maestro& maestro = fixture.maestro;
+	maestro.add_frame_buffer(Colors::ColorOrder::GRB, 3);
+	REQUIRE(maestro.get_frame_size() == 32 * 3);
+	REQUIRE(maestro.get_frame() == nullptr);
+
+	maestro.update(100);
+	unsigned char* frame = maestro.get_frame();
+	REQUIRE(frame != nullptr);
+
+	// The published frame matches the Maestro's output.
+	unsigned char rendered[32 * 3];
+	maestro.render_frame(rendered, Colors::ColorOrder::GRB, 3);
+	REQUIRE(memcmp(frame, rendered, sizeof(rendered)) == 0);
+
+	// Each frame is only returned once.
+	REQUIRE(maestro.get_frame() == nullptr);
+
+	SECTION("Verify that the frame buffer grows with the Sections.") {
+		sections[0].set_dimensions(8, 8);
+		maestro.update(200);
+		REQUIRE(maestro.get_frame_size() == 64 * 3);
+
+		frame = maestro.get_frame();
+		REQUIRE(frame != nullptr);
+		unsigned char resized[64 * 3];
+		maestro.render_frame(resized, Colors::ColorOrder::GRB, 3);
+		REQUIRE(memcmp(frame, resized, sizeof(resized)) == 0);
+	}
+}
+
+TEST_CASE("Apply gamma and brightness to the output.", "[Maestro]") {
+	WaveMaestro fixture(1, 4, 1, 100, false);
+	Section* sections = fixture.sections;
+	Maestro& maestro = fixture.maestro;
+	Colors::RGB color = {128, 64, 255};
+	sections[0].set_one(0, &color);
+
+	SECTION("Verify that the gamma tables are calculated correctly.") {
+		REQUIRE(Gamma::POWER_2_2[0] == 0);
+		REQUIRE(Gamma::POWER_2_2[128] == 14330);
+		REQUIRE(Gamma::POWER_2_2[255] == 65280);
+		REQUIRE(Gamma::CIE_LIGHTNESS[128] == 12131);
+		REQUIRE(Gamma::CIE_LIGHTNESS[255] == 65280);
+	}
+
+	SECTION("Verify that gamma is applied before brightness.") {
+		maestro.set_gamma(Gamma::POWER_2_2);
+		maestro.set_brightness(127);
+		Colors::RGB output = maestro.get_pixel_color(0, 0);
+		REQUIRE(output.r == ((Gamma::POWER_2_2[128] * 128) >> 16));
+		REQUIRE(output.g == ((Gamma::POWER_2_2[64] * 128) >> 16));
+		REQUIRE(output.b == 127);
+
+		// render_frame() produces the same output.
+		unsigned char frame[4 * 3];
+		maestro.render_frame(frame);
+		REQUIRE(frame[0] == output.r);
+		REQUIRE(frame[1] == output.g);
+		REQUIRE(frame[2] == output.b);
+	}
+
+	SECTION("Verify that turning off gamma at full brightness outputs colors unchanged.") {
+		maestro.set_gamma(Gamma::CIE_LIGHTNESS);
+		maestro.set_gamma(nullptr);
+		maestro.set_brightness(255);
+		REQUIRE(maestro.get_pixel_color(0, 0) == color);
+	}
+
+	SECTION("Verify that brightness without gamma matches Colors::scale8().") {
+		maestro.set_brightness(77);
+		Colors::RGB output = maestro.get_pixel_color(0, 0);
+		REQUIRE(output.r == Colors::scale8(128, 77));
+		REQUIRE(output.g == Colors::scale8(64, 77));
+		REQUIRE(output.b == Colors::scale8(255, 77));
+	}
+}
+
+TEST_CASE("Dither the output over time.", "[Maestro]") {
+	WaveMaestro fixture(1, 4, 1, 100, false);
+	Section* sections = fixture.sections;
+	Maestro& maestro = fixture.maestro;
+	Colors::RGB color = {10, 1, 200};
+	sections[0].set_one(0, &color);
+	maestro.set_brightness(16);
+
+	// At this brightness, the red and green levels fall between 0 and 1.
+	unsigned short levels[256];
+	Gamma::build_levels(levels, nullptr, 16);
+	REQUIRE(levels[10] == 170);
+	REQUIRE(levels[1] == 17);
+
+	unsigned char frame[4 * 3];
+	unsigned int sums[3] = {0, 0, 0};
+
+	SECTION("Verify that levels between output values are rounded down without dithering.") {
+		maestro.render_frame(frame);
+		REQUIRE(frame[0] == 0);
+		REQUIRE(frame[1] == 0);
+		REQUIRE(frame[2] == Colors::scale8(200, 16));
+	}
+
+	SECTION("Verify that the average output matches the levels exactly.") {
+		maestro.set_dithering(true);
+		REQUIRE(maestro.get_dithering());
+
+		// Every residual returns to where it started after 256 frames, so the sums equal the levels.
+		for (unsigned short frame_num = 0; frame_num < 256; frame_num++) {
+			maestro.render_frame(frame);
+			for (unsigned char channel = 0; channel < 3; channel++) {
+				sums[channel] += frame[channel];
+			}
+		}
+		REQUIRE(sums[0] == levels[10]);
+		REQUIRE(sums[1] == levels[1]);
+		REQUIRE(sums[2] == levels[200]);
+	}
+
+	SECTION("Verify that the output changes every frame while dithering.") {
+		maestro.set_dithering(true);
+		REQUIRE(maestro.get_changed());
+	}
+}
+
+TEST_CASE("Report the next time the output changes.", "[Maestro]") {
+	WaveMaestro fixture(1, 4, 1, 500, false);
+	Section* sections = fixture.sections;
+	Maestro& maestro = fixture.maestro;
+	maestro.update(20);
+
+	SECTION("Verify that the wakeup is the next Animation cycle.") {
+		REQUIRE(maestro.get_next_wakeup(20) == 500);
+		REQUIRE(maestro.get_next_wakeup(499) == 500);
+	}
+
+	SECTION("Verify that nothing changes before the next refresh.") {
+		sections[0].get_animation()->set_speed(10);
+		REQUIRE(maestro.get_next_wakeup(25) == 40);
+	}
+
+	SECTION("Verify that fading Pixels change on every refresh.") {
+		sections[0].get_animation()->set_fade(true);
+		maestro.update(500);
+		REQUIRE(maestro.get_next_wakeup(500) == 520);
+	}
+
+	SECTION("Verify that Show Events are included.") {
+		AnimationSetFadeEvent event(333, sections[0].get_animation(), true);
+		Event* events[] = {&event};
+		maestro.add_show(events, 1);
+		REQUIRE(maestro.get_next_wakeup(20) == 333);
+
+		// Once the Show is over, it no longer affects the wakeup.
+		maestro.update(333);
+		REQUIRE(maestro.get_next_wakeup(333) == 500);
+	}
+
+	SECTION("Verify that a stopped Maestro never wakes up.") {
+		maestro.set_running(false);
+		REQUIRE(maestro.get_next_wakeup(100) - 100 == (unsigned long)-1);
+	}
+}
+
+TEST_CASE("Dither fades in high precision.", "[Maestro]") {
+	Section sections[] = {
+		Section(1, 1)
+	};
+	Colors::RGB color = {2, 0, 0};
+	SolidAnimation animation(&color, 1, 1000);
+	sections[0].set_animation(&animation);
+	Maestro maestro(sections, 1);
+	maestro.set_dithering(true);
+
+	unsigned char frame[3];
+	unsigned int sum = 0;
+
+	SECTION("Verify that fades round to 8 bits in DIRECT mode.") {
+		maestro.update(1000);
+		maestro.update(1250);
+		REQUIRE(sections[0].get_pixel_color(0).r == 0);
+		for (unsigned short frame_num = 0; frame_num < 256; frame_num++) {
+			maestro.render_frame(frame);
+			sum += frame[0];
+		}
+		REQUIRE(sum == 0);
+	}
+
+	SECTION("Verify that HIGH_PRECISION mode keeps the steps between 8-bit colors.") {
+		sections[0].set_storage_mode(Section::StorageMode::HIGH_PRECISION);
+		maestro.update(1000);
+
+		// A quarter of the way from 0 to 2 is 0.5, which averages to 128 over 256 frames.
+		maestro.update(1250);
+		REQUIRE(maestro.get_changed());
+		REQUIRE(sections[0].get_pixel_color(0).r == 0);
+		for (unsigned short frame_num = 0; frame_num < 256; frame_num++) {
+			maestro.render_frame(frame);
+			sum += frame[0];
+		}
+		REQUIRE(sum == 128);
+
+		// The low byte is dropped once the fade completes.
+		maestro.update(2000);
+		REQUIRE(sections[0].get_pixel_color(0) == color);
+		sum = 0;
+		for (unsigned short frame_num = 0; frame_num < 256; frame_num++) {
+			maestro.render_frame(frame);
+			sum += frame[0];
+		}
+		REQUIRE(sum == 2 * 256);
+	}
+
+	SECTION("Verify that the low bytes are interpolated between levels.") {
+		sections[0].set_storage_mode(Section::StorageMode::HIGH_PRECISION);
+		maestro.set_gamma(Gamma::POWER_2_2);
+		color = {130, 0, 0};
+		maestro.update(1000);
+
+		// A quarter of the way from 0 to 130 is 32.5, which lies halfway between the levels of 32 and 33.
+		maestro.update(1250);
+		for (unsigned short frame_num = 0; frame_num < 256; frame_num++) {
+			maestro.render_frame(frame);
+			sum += frame[0];
+		}
+		REQUIRE(sum == (unsigned int)((Gamma::POWER_2_2[32] + Gamma::POWER_2_2[33]) >> 1));
+	}
+}
@@ -7,30 +7,30 @@ using namespace PixelMaestro;
 
 TEST_CASE("Create and manipulate a Pixel.", "[Pixel]") {
     Pixel pixel;
-    unsigned short cycleSpeed = 100;
-    unsigned short refreshRate = 10;
+    unsigned short fadeInterval = 100;
     Colors::RGB color = Colors::RED;
     bool fade = true;
 
     SECTION("Set a new color.") {
         pixel.set_next_color(&color, false, 0, 0);
-        pixel.update();
+        pixel.update(0);
         REQUIRE(*pixel.get_color() == Colors::RED);
     }
 
-    // Change to red, allow fading, finish a transition every 10 ms
-    pixel.set_next_color(&color, fade, cycleSpeed, refreshRate);
+    // Change to red, allow fading, finish the transition after 100 ms
+    pixel.set_next_color(&color, fade, fadeInterval, 0);
 
-    // Calculate the diff between the refresh and cycle rates
-    unsigned short diff = (unsigned short)(cycleSpeed / (float)refreshRate);
-
-    // Update the Pixel
-    pixel.update();
-
-    SECTION("Update and check the current color.") {
+    SECTION("Color is based on the time elapsed since the fade started.") {
+        pixel.update(fadeInterval / 2);
         Colors::RGB currentColor = *pixel.get_color();
-        REQUIRE(currentColor.r == (color.r > 0 ? color.r / diff : 0));
-        REQUIRE(currentColor.g == (color.g > 0 ? color.g / diff : 0));
-        REQUIRE(currentColor.b == (color.b > 0 ? color.b / diff : 0));
+        REQUIRE(currentColor.r == color.r / 2);
+        REQUIRE(currentColor.g == 0);
+        REQUIRE(currentColor.b == 0);
+    }
+
+    SECTION("Skipped updates don't affect the fade.") {
+        pixel.update(10);
+        pixel.update(fadeInterval + 50);
+        REQUIRE(*pixel.get_color() == Colors::RED);
     }
 }
@@ -0,0 +1,88 @@
+#include <string.h>
+#include "../catch/single_include/catch.hpp"
+#include "animation/sparkleanimation.h"
+#include "random.h"
+#include "randomtest.h"
+#include "section.h"
+
+using namespace PixelMaestro;
+
+TEST_CASE("Random streams are reproducible.", "[Random]") {
+	Random first(42);
+	Random second(42);
+	Random third(43);
+
+	bool different = false;
+	for (unsigned char i = 0; i < 16; i++) {
+		unsigned long value = first.next();
+		REQUIRE(value == second.next());
+		different |= (value != third.next());
+	}
+	REQUIRE(different);
+
+	first.set_seed(7);
+	second.set_seed(7);
+	unsigned char first_buffer[11];
+	unsigned char second_buffer[11];
+	first.fill(first_buffer, 11);
+	for (unsigned char i = 0; i < 11; i++) {
+		second_buffer[i] = second.next_byte();
+	}
+	REQUIRE(memcmp(first_buffer, second_buffer, 11) == 0);
+}
+
+TEST_CASE("Random values stay in range.", "[Random]") {
+	Random random(1);
+	for (unsigned short i = 0; i < 1000; i++) {
+		REQUIRE(random.next_range(10) < 10);
+	}
+
+	unsigned char mask[64];
+	random.fill_mask(mask, 64, 255);
+	for (unsigned char i = 0; i < 64; i++) {
+		REQUIRE(mask[i] == 1);
+	}
+}
+
+TEST_CASE("Animations with the same seed match.", "[Random]") {
+	Section first(8, 4);
+	Section second(8, 4);
+	SparkleAnimation first_animation(Colors::COLORWHEEL, 12, 10);
+	SparkleAnimation second_animation(Colors::COLORWHEEL, 12, 10);
+	first_animation.set_seed(5);
+	second_animation.set_seed(5);
+	first.set_animation(&first_animation);
+	second.set_animation(&second_animation);
+
+	for (unsigned long time = 10; time <= 100; time += 10) {
+		first.update(time);
+		second.update(time);
+		for (unsigned int pixel = 0; pixel < first.get_dimensions()->size(); pixel++) {
+			REQUIRE(first.get_pixel_color(pixel) == second.get_pixel_color(pixel));
+		}
+	}
+}
+
+TEST_CASE("Sparkle Pixels using a mask for each row.", "[Random]") {
+	Section section(8, 4);
+	SparkleAnimation animation(Colors::COLORWHEEL, 12, 10, 0, 100);
+	animation.set_fade(false);
+	animation.set_seed(7);
+	section.set_animation(&animation);
+	section.update(10);
+
+	// Each row is lit according to the next mask from the same stream.
+	Random random(7);
+	unsigned char mask[8];
+	for (unsigned short y = 0; y < 4; y++) {
+		random.fill_mask(mask, 8, 100);
+		for (unsigned short x = 0; x < 8; x++) {
+			if (mask[x]) {
+				REQUIRE(section.get_pixel_color(section.get_pixel_index(x, y)) == Colors::COLORWHEEL[x]);
+			}
+			else {
+				REQUIRE(section.get_pixel_color(section.get_pixel_index(x, y)) == Colors::BLACK);
+			}
+		}
+	}
+}
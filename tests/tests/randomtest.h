@@ -0,0 +1,14 @@
+#ifndef RANDOMTEST_H
+#define RANDOMTEST_H
+
+class RandomTest
+{
+    public:
+        RandomTest();
+
+    protected:
+
+    private:
+};
+
+#endif // RANDOMTEST_H
@@ -1,41 +1,408 @@
+#include <string.h>
 #include "../catch/single_include/catch.hpp"
+#include "animation/mandelbrotanimation.h"
+#include "animation/plasmaanimation.h"
+#include "animation/solidanimation.h"
+#include "animation/waveanimation.h"
 #include "colors.h"
 #include "point.h"
 #include "section.h"
 #include "sectiontest.h"
+#include "threadpool.h"
 
 using namespace PixelMaestro;
 
-TEST_CASE("Create and manipulate a section->", "[Section]") {
-	Point *layout = new Point(1, 12);
-	Pixel pixels[layout->x * layout->y];
-	Section *section = new Section(&pixels[0], layout);
-	
-	int testPixelIndex = 11;
-	
+TEST_CASE("Create and manipulate a section.", "[Section]") {
+	Section section(12, 1);
+	unsigned int test_pixel = 11;
+
 	SECTION("Verify that Pixels are set correctly.") {
-		REQUIRE(section->get_pixel(testPixelIndex) == &pixels[testPixelIndex]);
-		REQUIRE(section->get_num_pixels() == (layout->x * layout->y));
-		REQUIRE(section->get_dimensions()->x == layout->x);
-		REQUIRE(section->get_dimensions()->y == layout->y);
+		REQUIRE(section.get_dimensions()->size() == 12);
+		REQUIRE(section.get_dimensions()->x == 12);
+		REQUIRE(section.get_dimensions()->y == 1);
 	}
-	
+
 	SECTION("Verify that Animations and Colors are set correctly.") {
-		section->set_color_animation(Section::ColorAnimations::SOLID, false);
-		section->set_colors(Colors::COLORWHEEL, 12);
-		section->set_cycle_interval(100);
-		
-		// Disable fading
-		if (section->get_fade()) {
-			section->toggle_fade();
+		SolidAnimation animation(Colors::COLORWHEEL, 12, 100);
+		animation.set_fade(false);
+		section.set_animation(&animation);
+		section.update(101);
+
+		REQUIRE(section.get_pixel_color(test_pixel) == Colors::COLORWHEEL[test_pixel]);
+	}
+}
+
+TEST_CASE("Track which Pixels changed during an update.", "[Section]") {
+	Section section(10, 5);
+	Colors::RGB colors[] = {Colors::RED, Colors::GREEN};
+	SolidAnimation animation(colors, 2, 100);
+	animation.set_fade(false);
+	section.set_animation(&animation);
+
+	// A new Section is drawn in full on the first update.
+	section.update(0);
+	REQUIRE(section.get_changed());
+
+	section.update(20);
+	REQUIRE_FALSE(section.get_changed());
+
+	SECTION("Verify that a single Pixel change produces a single span.") {
+		section.set_one(33, &colors[1]);
+		section.update(40);
+
+		Section::Span spans[4];
+		REQUIRE(section.get_dirty_spans(spans, 4) == 1);
+		REQUIRE(spans[0].start <= 33);
+		REQUIRE(spans[0].start + spans[0].length > 33);
+		REQUIRE(section.get_changed());
+
+		section.update(60);
+		REQUIRE_FALSE(section.get_changed());
+	}
+
+	SECTION("Verify that invalidating covers the entire Section.") {
+		section.invalidate();
+		section.update(40);
+
+		Section::Span spans[4];
+		REQUIRE(section.get_dirty_spans(spans, 4) == 1);
+		REQUIRE(spans[0].start == 0);
+		REQUIRE(spans[0].length == section.get_dimensions()->size());
+	}
+}
+
+TEST_CASE("Stop fading once every Pixel reaches its next color.", "[Section]") {
+	Section section(4, 4);
+	Colors::RGB colors[] = {Colors::RED};
+	SolidAnimation animation(colors, 1, 100);
+	section.set_animation(&animation);
+
+	// The first cycle starts a fade from black to red that lasts 100ms.
+	section.update(100);
+	section.update(150);
+	REQUIRE(section.get_changed());
+	REQUIRE(section.get_pixels()[0].r > 0);
+	REQUIRE(section.get_pixels()[0].r < 255);
+
+	// The fade completes on the next cycle and nothing else changes afterwards.
+	section.update(200);
+	REQUIRE(section.get_pixels()[0] == Colors::RED);
+	section.update(250);
+	REQUIRE_FALSE(section.get_changed());
+}
+
+TEST_CASE("Render a Section in bands.", "[Section]") {
+	Section serial(30, 40);
+	Section banded(30, 40);
+	MandelbrotAnimation serial_animation(Colors::COLORWHEEL, 12, 50);
+	MandelbrotAnimation banded_animation(Colors::COLORWHEEL, 12, 50);
+	serial.set_animation(&serial_animation);
+	banded.set_animation(&banded_animation);
+
+	ThreadPool pool(4);
+	banded.set_executor(&pool);
+
+	// Rendering in bands should give the same result as rendering serially, including fades.
+	for (unsigned long time = 0; time <= 500; time += 20) {
+		serial.update(time);
+		banded.update(time);
+		REQUIRE(memcmp(serial.get_pixels(), banded.get_pixels(), serial.get_dimensions()->size() * sizeof(Colors::RGB)) == 0);
+		REQUIRE(serial.get_changed() == banded.get_changed());
+	}
+}
+
+TEST_CASE("Render an INDEXED Section in bands.", "[Section]") {
+	Section serial(32, 64);
+	Section banded(32, 64);
+	serial.set_storage_mode(Section::StorageMode::INDEXED);
+	banded.set_storage_mode(Section::StorageMode::INDEXED);
+	// Enough iterations that the bands overlap in time.
+	MandelbrotAnimation serial_animation(Colors::COLORWHEEL, 12, 50, 0, 200);
+	MandelbrotAnimation banded_animation(Colors::COLORWHEEL, 12, 50, 0, 200);
+	serial.set_animation(&serial_animation);
+	banded.set_animation(&banded_animation);
+
+	ThreadPool pool(4);
+	banded.set_executor(&pool);
+
+	// Rendering in bands should store the same indices as rendering serially.
+	for (unsigned long time = 0; time <= 500; time += 20) {
+		serial.update(time);
+		banded.update(time);
+		REQUIRE(memcmp(serial.get_indices(), banded.get_indices(), serial.get_dimensions()->size()) == 0);
+		REQUIRE(serial.get_changed() == banded.get_changed());
+	}
+}
+
+TEST_CASE("Update a Section without any Pixels.", "[Section]") {
+	Section rows(8, 0);
+	Section columns(0, 8);
+	MandelbrotAnimation mandelbrot(Colors::COLORWHEEL, 12, 20);
+	WaveAnimation wave(Colors::COLORWHEEL, 12, 20);
+	rows.set_animation(&mandelbrot);
+	columns.set_animation(&wave);
+
+	ThreadPool pool(4);
+	columns.set_executor(&pool);
+
+	// Neither Section has anything to render, so updating them should do nothing.
+	for (unsigned long time = 0; time <= 100; time += 20) {
+		rows.update(time);
+		columns.update(time);
+	}
+	REQUIRE_FALSE(rows.get_changed());
+	REQUIRE_FALSE(columns.get_changed());
+}
+
+TEST_CASE("Zoom into a MandelbrotAnimation.", "[Section]") {
+	Section section(16, 8);
+	MandelbrotAnimation animation(Colors::COLORWHEEL, 12, 10, 0, 50);
+	animation.set_fade(false);
+	section.set_animation(&animation);
+
+	SECTION("Verify that the view reaches its target.") {
+		animation.set_target(-0.75, 0.1, 8, 4);
+		for (unsigned long time = 10; time <= 40; time += 10) {
+			section.update(time);
+		}
+		REQUIRE(animation.get_center_real() == -0.75);
+		REQUIRE(animation.get_zoom() > 7.99);
+		REQUIRE(animation.get_zoom() < 8.01);
+	}
+
+	SECTION("Verify that zoom levels of 0 or less are ignored.") {
+		animation.set_zoom(2);
+		animation.set_zoom(0);
+		animation.set_zoom(-1);
+		animation.set_target(0, 0, 0, 4);
+		section.update(10);
+		section.update(20);
+		REQUIRE(animation.get_zoom() == 2);
+	}
+
+	SECTION("Verify that changing the palette reuses cached iterations.") {
+		section.update(10);
+		Colors::RGB colors[8];
+		for (unsigned char index = 0; index < 8; index++) {
+			colors[index] = Colors::COLORWHEEL[index];
+		}
+		animation.set_colors(colors, 8);
+		section.update(20);
+
+		MandelbrotAnimation reference(colors, 8, 10, 0, 50);
+		reference.set_fade(false);
+		reference.set_cycle_index(1);
+		Section reference_section(16, 8);
+		reference_section.set_animation(&reference);
+		reference_section.update(10);
+		REQUIRE(memcmp(section.get_pixels(), reference_section.get_pixels(), section.get_dimensions()->size() * sizeof(Colors::RGB)) == 0);
+	}
+
+	SECTION("Verify that the default iteration limit follows the palette size.") {
+		MandelbrotAnimation palette(Colors::COLORWHEEL, 12, 10);
+		palette.set_fade(false);
+		Section palette_section(16, 8);
+		palette_section.set_animation(&palette);
+		REQUIRE(palette.get_max_iterations() == 0);
+
+		MandelbrotAnimation reference(Colors::COLORWHEEL, 12, 10, 0, 12);
+		reference.set_fade(false);
+		Section reference_section(16, 8);
+		reference_section.set_animation(&reference);
+
+		palette_section.update(10);
+		reference_section.update(10);
+		REQUIRE(memcmp(palette_section.get_pixels(), reference_section.get_pixels(), palette_section.get_dimensions()->size() * sizeof(Colors::RGB)) == 0);
+
+		palette.set_colors(Colors::COLORWHEEL, 6);
+		reference.set_colors(Colors::COLORWHEEL, 6);
+		reference.set_max_iterations(6);
+		palette_section.update(20);
+		reference_section.update(20);
+		REQUIRE(memcmp(palette_section.get_pixels(), reference_section.get_pixels(), palette_section.get_dimensions()->size() * sizeof(Colors::RGB)) == 0);
+	}
+}
+
+TEST_CASE("Move a PlasmaAnimation.", "[Section]") {
+	Section section(24, 8);
+	Colors::RGB colors[] = {Colors::RED};
+	PlasmaAnimation animation(colors, 1, 10);
+	animation.set_fade(false);
+	section.set_animation(&animation);
+
+	// With a single color, palette cycling can't change anything, so any change comes from the plasma moving.
+	section.update(10);
+	section.update(20);
+	REQUIRE_FALSE(section.get_changed());
+
+	Colors::RGB palette[12];
+	for (unsigned char index = 0; index < 12; index++) {
+		palette[index] = Colors::COLORWHEEL[index];
+	}
+	animation.set_colors(palette, 12);
+	animation.set_motion(16);
+	section.update(30);
+	Colors::RGB first[24 * 8];
+	for (unsigned int pixel = 0; pixel < section.get_dimensions()->size(); pixel++) {
+		first[pixel] = section.get_pixel_color(pixel);
+	}
+
+	// Cycling the palette keeps Pixels that share a color together, but moving the plasma splits them up.
+	section.update(40);
+	bool moved = false;
+	for (unsigned int pixel = 0; pixel < section.get_dimensions()->size(); pixel++) {
+		moved |= ((first[pixel] == first[0]) != (section.get_pixel_color(pixel) == section.get_pixel_color(0)));
+	}
+	REQUIRE(moved);
+}
+
+TEST_CASE("Store Pixels as palette indices.", "[Section]") {
+	Section section(4, 1);
+	section.set_storage_mode(Section::StorageMode::INDEXED);
+	Colors::RGB colors[] = {Colors::RED, Colors::GREEN, Colors::BLUE};
+	SolidAnimation animation(colors, 3, 100);
+	animation.set_fade(false);
+	section.set_animation(&animation);
+
+	REQUIRE(section.get_pixels() == nullptr);
+	section.update(0);
+
+	SECTION("Verify that colors resolve through the palette.") {
+		section.set_one(0, &colors[2]);
+		section.set_one_index(1, 4);
+		section.set_one(2, &Colors::BLACK);
+		REQUIRE(section.get_indices()[0] == 2);
+		REQUIRE(section.get_pixel_color(0) == Colors::BLUE);
+		REQUIRE(section.get_pixel_color(1) == Colors::GREEN);
+		REQUIRE(section.get_indices()[2] == Section::INDEX_OFF);
+		REQUIRE(section.get_pixel_color(2) == Colors::BLACK);
+	}
+
+	SECTION("Verify that rotating the palette changes every Pixel.") {
+		section.set_one_index(0, 0);
+		section.set_palette_offset(1);
+		section.update(20);
+		REQUIRE(section.get_indices()[0] == 0);
+		REQUIRE(section.get_pixel_color(0) == Colors::GREEN);
+		REQUIRE(section.get_changed());
+	}
+}
+
+TEST_CASE("Cache an Animation's index map.", "[Section]") {
+	Section section(5, 2);
+	Colors::RGB colors[] = {Colors::RED, Colors::GREEN, Colors::BLUE};
+	WaveAnimation animation(colors, 3, 100);
+	animation.set_fade(false);
+	section.set_animation(&animation);
+
+	SECTION("Verify that the cycle index rotates the cached map.") {
+		section.update(100);
+		REQUIRE(section.get_pixel_color(4) == Colors::GREEN);
+		section.update(200);
+		REQUIRE(section.get_pixel_color(4) == Colors::BLUE);
+	}
+
+	SECTION("Verify that the map is rebuilt after the Section changes.") {
+		section.update(100);
+		section.set_dimensions(7, 2);
+		animation.set_orientation(Animation::Orientations::VERTICAL);
+		section.update(200);
+		REQUIRE(section.get_pixel_color(6) == Colors::GREEN);
+		REQUIRE(section.get_pixel_color(13) == Colors::BLUE);
+	}
+
+	SECTION("Verify that INDEXED mode matches DIRECT mode.") {
+		Section indexed(5, 2);
+		indexed.set_storage_mode(Section::StorageMode::INDEXED);
+		WaveAnimation indexed_animation(colors, 3, 100);
+		indexed_animation.set_fade(false);
+		indexed.set_animation(&indexed_animation);
+
+		for (unsigned long time = 0; time <= 500; time += 100) {
+			section.update(time);
+			indexed.update(time);
+			for (unsigned int pixel = 0; pixel < section.get_dimensions()->size(); pixel++) {
+				REQUIRE(section.get_pixel_color(pixel) == indexed.get_pixel_color(pixel));
+			}
 		}
-		section->update(101);
-		
-		Colors::RGB pixelColor = section->get_pixel_color(testPixelIndex);
-		Colors::RGB targetColor = Colors::COLORWHEEL[testPixelIndex];
+	}
+}
+
+TEST_CASE("Stack layers on a Section.", "[Section]") {
+	Section section(4, 1);
+	Colors::RGB colors[] = {Colors::RED};
+	SolidAnimation animation(colors, 1, 100);
+	animation.set_fade(false);
+	section.set_animation(&animation);
+
+	Section::Overlay* add = section.add_layer(Colors::MixMode::ADD, 255);
+	SolidAnimation add_animation(colors, 1, 100);
+	add_animation.set_fade(false);
+	add->section->set_animation(&add_animation);
+
+	Section::Overlay* difference = section.add_layer(Colors::MixMode::DIFFERENCE, 255);
+	SolidAnimation difference_animation(colors, 1, 100);
+	difference_animation.set_fade(false);
+	difference->section->set_animation(&difference_animation);
+
+	REQUIRE(section.get_num_layers() == 2);
+	REQUIRE(section.get_overlay() == add);
+	REQUIRE(section.get_layer(1) == difference);
+	REQUIRE(section.get_layer(2) == nullptr);
+
+	SECTION("Verify that layers blend from the bottom up.") {
+		Colors::RGB base = {100, 100, 100};
+		Colors::RGB add_color = {50, 0, 200};
+		Colors::RGB difference_color = {255, 0, 0};
+		section.set_one(0, &base);
+		add->section->set_one(0, &add_color);
+		difference->section->set_one(0, &difference_color);
+
+		Colors::RGB stacked = {105, 100, 255};
+		REQUIRE(section.get_pixel_color(0) == stacked);
 
-		REQUIRE((int)pixelColor.r == (int)targetColor.r);
-		REQUIRE((int)pixelColor.g == (int)targetColor.g);
-		REQUIRE((int)pixelColor.b == (int)targetColor.b);
+		difference->visible = false;
+		Colors::RGB added = {150, 100, 255};
+		REQUIRE(section.get_pixel_color(0) == added);
+
+		add->alpha = 0;
+		REQUIRE(section.get_pixel_color(0) == base);
+
+		unsigned char buffer[4 * 3];
+		section.render_frame(buffer);
+		REQUIRE(buffer[0] == base.r);
+		REQUIRE(buffer[1] == base.g);
+		REQUIRE(buffer[2] == base.b);
+	}
+
+	SECTION("Verify that changing a layer's options redraws the Section.") {
+		section.update(0);
+		section.update(20);
+		REQUIRE_FALSE(section.get_changed());
+
+		difference->visible = false;
+		section.update(40);
+		REQUIRE(section.get_changed());
 	}
+
+	SECTION("Verify that removing a layer moves the layers above it down.") {
+		section.remove_layer(0);
+		REQUIRE(section.get_num_layers() == 1);
+		REQUIRE(section.get_overlay() == difference);
+		section.remove_overlay();
+		REQUIRE(section.get_num_layers() == 0);
+		REQUIRE(section.get_overlay() == nullptr);
+	}
+}
+
+TEST_CASE("Give new layers a default opacity.", "[Section]") {
+	Section section(4, 1);
+
+	REQUIRE(section.add_layer()->alpha == 128);
+	REQUIRE(section.add_layer(Colors::MixMode::MULTIPLY)->alpha == 255);
+	REQUIRE(section.add_layer(Colors::MixMode::OVERLAY)->alpha == 255);
+	REQUIRE(section.add_layer(Colors::MixMode::MULTIPLY, 64)->alpha == 64);
+
+	Section overlaid(4, 1);
+	REQUIRE(overlaid.add_overlay(Colors::MixMode::ADD)->alpha == 255);
 }
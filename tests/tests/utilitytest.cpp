@@ -12,3 +12,11 @@ TEST_CASE("abs_int returns absolute value.", "[int]") {
 	int neg = -15;
 	REQUIRE(Utility::abs_int(neg) == (neg * -1));
 }
+
+TEST_CASE("sin8 returns an integer sine wave.", "[int]") {
+	REQUIRE(Utility::sin8(0) == 128);
+	REQUIRE(Utility::sin8(64) == 255);
+	REQUIRE(Utility::sin8(128) == 127);
+	REQUIRE(Utility::sin8(192) == 0);
+	REQUIRE(Utility::sin8(32) == 255 - Utility::sin8(160));
+}